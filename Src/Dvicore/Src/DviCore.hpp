@@ -13,10 +13,20 @@
 #include "GL_Buffers.hpp"
 #include "GL_Shader.hpp"
 #include "GL_Texture.hpp"
+#include "GL_TextureArray.hpp"
+#include "GL_RenderQueue.hpp"
 #include "GL_VertexArray.hpp"
+#include "GL_QuadKernel.hpp"
 #include "GL_Renderer.hpp"
+#include "GL_TextRenderer.hpp"
+#include "GL_Tilemap.hpp"
+#include "GL_ParticleSystem.hpp"
+#include "GL_SpriteBuffer.hpp"
+#include "GL_SpriteCuller.hpp"
+#include "GL_StateCache.hpp"
 #include "GL_Info.hpp"
 #include "GL_FrameBuffer.hpp"
+#include "GL_CachedLayer.hpp"
 #include "GL_Context.hpp"
 #include "GL_Camera.hpp"
 #include "Event.hpp"
@@ -1,5 +1,6 @@
 #include "ImGuiLayer.hpp"
 #include "Assert.hpp"
+#include "GL_StateCache.hpp"
 
 namespace DviCore 
 {
@@ -63,6 +64,9 @@ namespace DviCore
             ImGui::RenderPlatformWindowsDefault();
             glfwMakeContextCurrent(backup_current_context);
         }  
+
+        // The ImGui backend binds its own program, buffers and textures behind the cache.
+        GLStateCache::Invalidate();
     }
 
     void ImGuiLayer::CreateDockspace()
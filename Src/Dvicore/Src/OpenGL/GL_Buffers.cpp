@@ -1,61 +1,62 @@
 #include "GL_Buffers.hpp"
+#include "GL_StateCache.hpp"
 
 namespace DviCore 
 {
     VertexBuffer::VertexBuffer(uint32_t size) 
 	{
 		glCreateBuffers(1, &m_VertexBufferID);
-        glBindBuffer(GL_ARRAY_BUFFER, m_VertexBufferID);
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_VertexBufferID);
         glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
     }
 
     VertexBuffer::VertexBuffer(float * vertices, uint32_t size) 
 	{
 		glCreateBuffers(1, &m_VertexBufferID);
-		glBindBuffer(GL_ARRAY_BUFFER, m_VertexBufferID);
+		GLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_VertexBufferID);
 		glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
 	}
 
     VertexBuffer::~VertexBuffer() 
 	{
-		glDeleteBuffers(1, &m_VertexBufferID);
+		GLStateCache::DeleteBuffer(m_VertexBufferID);
 	}
 
 	void VertexBuffer::Bind() const 
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_VertexBufferID);
+		GLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_VertexBufferID);
 	}
 
 	void VertexBuffer::Unbind() const 
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		GLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 
 	void VertexBuffer::SetData(const void * data, uint32_t size) const 
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_VertexBufferID);
+		GLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_VertexBufferID);
 		glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
 	}
 
 	IndexBuffer::IndexBuffer(uint32_t * indices, uint32_t count) : m_Count(count) 
 	{
 		glCreateBuffers(1, &m_IndexBufferID);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexBufferID);
+		GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexBufferID);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32_t), indices, GL_STATIC_DRAW);
 	}
 
 	IndexBuffer::~IndexBuffer() 
 	{
-		glDeleteBuffers(1, &m_IndexBufferID);
+		GLStateCache::DeleteBuffer(m_IndexBufferID);
 	}
 
 	void IndexBuffer::Bind() const 
 	{
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexBufferID);
+		GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexBufferID);
 	}
 
 	void IndexBuffer::Unbind() const 
 	{
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "GL_CachedLayer.hpp"
+#include "GL_StateCache.hpp"
+#include "Assert.hpp"
+#include "Instrument.hpp"
+
+#include <algorithm>
+
+namespace DviCore
+{
+    // The corners of an orthographic view in camera space.
+    static void ViewBounds(const glm::mat4& projection, glm::vec2& min, glm::vec2& max)
+    {
+        glm::mat4 inverse = glm::inverse(projection);
+        glm::vec2 a = glm::vec2(inverse * glm::vec4(-1.0f, -1.0f, 0.0f, 1.0f));
+        glm::vec2 b = glm::vec2(inverse * glm::vec4(1.0f, 1.0f, 0.0f, 1.0f));
+        min = glm::min(a, b);
+        max = glm::max(a, b);
+    }
+
+    CachedLayer::CachedLayer(const CachedLayerSpecifications& specification) :
+        m_Specification(specification)
+    {
+    }
+
+    bool CachedLayer::NeedsCapture(const glm::mat4& view, const glm::mat4& projection) const
+    {
+        if(!m_Valid || m_Target == nullptr || projection != m_Projection)
+            return true;
+
+        glm::mat4 camera_transform = glm::inverse(view);
+        if(glm::mat3(camera_transform) != glm::mat3(m_CameraTransform))
+            return true;
+
+        glm::vec2 min, max;
+        ViewBounds(projection, min, max);
+        glm::vec2 offset = glm::vec2(glm::inverse(m_CameraTransform) * camera_transform[3]);
+        return glm::any(glm::lessThan(offset + min, m_Min)) || glm::any(glm::greaterThan(offset + max, m_Max));
+    }
+
+    void CachedLayer::BeginCapture(const glm::mat4& view, const glm::mat4& projection)
+    {
+        DVI_PROFILE_SCOPE("CachedLayer::Capture");
+        DVIMANA_ASSERT(Supports(projection), "Only orthographic layers can be cached!");
+
+        const FrameConstants& frame = Renderer::GetFrameConstants();
+        m_PreviousView = frame.View;
+        m_PreviousProjection = frame.Projection;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_PreviousFrameBuffer);
+        glGetIntegerv(GL_VIEWPORT, m_PreviousViewport);
+
+        // The cached frame keeps the screen's texel density, so drawing it back maps texels to pixels one to one.
+        float scale = 1.0f + 2.0f * m_Specification.Margin;
+        uint32_t width = std::clamp(static_cast<uint32_t>(m_PreviousViewport[2] * scale), 1u, m_Specification.MaxSize);
+        uint32_t height = std::clamp(static_cast<uint32_t>(m_PreviousViewport[3] * scale), 1u, m_Specification.MaxSize);
+        Resize(width, height);
+
+        m_CameraTransform = glm::inverse(view);
+        m_Projection = projection;
+        ViewBounds(projection, m_Min, m_Max);
+        m_Min *= scale;
+        m_Max *= scale;
+
+        m_FrameBuffer->Bind();
+        const float clear_color[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        GLStateCache::DepthMask(true);
+        glClearNamedFramebufferfv(m_FrameBuffer->GetFrameBufferID(), GL_COLOR, 0, clear_color);
+        glClearNamedFramebufferfi(m_FrameBuffer->GetFrameBufferID(), GL_DEPTH_STENCIL, 0, 1.0f, 0);
+
+        glm::mat4 capture_projection = glm::scale(glm::mat4(1.0f), glm::vec3(1.0f / scale, 1.0f / scale, 1.0f)) * projection;
+        BatchRenderer::Begin(Camera(capture_projection), m_CameraTransform);
+    }
+
+    void CachedLayer::EndCapture()
+    {
+        BatchRenderer::End();
+
+        GLStateCache::BindFramebuffer(static_cast<uint32_t>(m_PreviousFrameBuffer));
+        Renderer::SetViewport(m_PreviousViewport[0], m_PreviousViewport[1], m_PreviousViewport[2], m_PreviousViewport[3]);
+        Renderer::UpdateFrameConstants(m_PreviousView, m_PreviousProjection);
+
+        m_Target->Rendered();
+        m_Valid = true;
+        m_Captured = true;
+        m_Status.Captures++;
+    }
+
+    void CachedLayer::Draw(float depth)
+    {
+        if(!m_Valid)
+            return;
+
+        if(m_Captured)
+            m_Captured = false;
+        else
+            m_Status.Reuses++;
+
+        glm::vec2 center = (m_Min + m_Max) * 0.5f;
+        glm::mat4 transform = m_CameraTransform * glm::translate(glm::mat4(1.0f), glm::vec3(center, 0.0f)) * glm::scale(glm::mat4(1.0f), glm::vec3(m_Max - m_Min, 1.0f));
+        transform[3].z = depth;
+        BatchRenderer::Quad(transform, m_Target);
+    }
+
+    void CachedLayer::Resize(uint32_t width, uint32_t height)
+    {
+        if(m_Target != nullptr && m_Target->Width() == static_cast<int32_t>(width) && m_Target->Height() == static_cast<int32_t>(height))
+            return;
+
+        FrameBufferSpecifications specification;
+        specification.Width = width;
+        specification.Height = height;
+
+        m_FrameBuffer.reset();
+        m_Target = std::make_shared<Texture>(width, height, GL_RGBA8);
+        m_FrameBuffer = std::make_unique<FrameBuffer>(specification, m_Target);
+    }
+}
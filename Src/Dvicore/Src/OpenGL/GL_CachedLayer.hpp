@@ -0,0 +1,71 @@
+#pragma once
+
+#include <memory>
+
+#include "GL_FrameBuffer.hpp"
+#include "GL_Renderer.hpp"
+
+namespace DviCore
+{
+    struct CachedLayerSpecifications
+    {
+        // Share of the view cached beyond each of its edges, the camera can pan that far before the layer is drawn again.
+        float Margin{0.5f};
+        uint32_t MaxSize{4096};
+    };
+
+    // Keeps a static group of quads in an offscreen texture and draws it back as a single quad. The cached frame covers the
+    // view plus a margin and stays valid while the projection and the camera's orientation are unchanged and the view stays
+    // inside it, anything else about the layer changing has to be reported through Invalidate().
+    // Only orthographic projections are cached, the layer is flattened into one plane. Members are blended over a transparent
+    // frame, so a translucent member with nothing under it comes back fainter than it was drawn.
+    class CachedLayer
+    {
+        public:
+            CachedLayer(const CachedLayerSpecifications& specification = CachedLayerSpecifications());
+            ~CachedLayer() = default;
+
+            static bool Supports(const glm::mat4& projection) { return projection[2][3] == 0.0f; }
+
+            void Invalidate() { m_Valid = false; }
+            bool NeedsCapture(const glm::mat4& view, const glm::mat4& projection) const;
+
+            // Opens a batch into the cached frame for the given camera, the layer's quads are drawn before EndCapture().
+            // EndCapture() restores the bound frame, the viewport and the frame constants.
+            void BeginCapture(const glm::mat4& view, const glm::mat4& projection);
+            void EndCapture();
+
+            // Submits the cached frame to the current batch at the given depth.
+            void Draw(float depth = 0.0f);
+
+            struct LayerStatus
+            {
+                uint32_t Captures{0};
+                uint32_t Reuses{0};
+            };
+
+            const LayerStatus& Status() const { return m_Status; }
+            void StatusReset() { m_Status = LayerStatus(); }
+
+        private:
+            void Resize(uint32_t width, uint32_t height);
+
+        private:
+            CachedLayerSpecifications m_Specification;
+            std::shared_ptr<Texture> m_Target{nullptr};
+            std::unique_ptr<FrameBuffer> m_FrameBuffer{nullptr};
+
+            bool m_Valid{false};
+            glm::mat4 m_CameraTransform{1.0f};
+            glm::mat4 m_Projection{1.0f};
+            glm::vec2 m_Min{0.0f}, m_Max{0.0f};
+
+            int32_t m_PreviousFrameBuffer{0};
+            int32_t m_PreviousViewport[4]{};
+            glm::mat4 m_PreviousView{1.0f};
+            glm::mat4 m_PreviousProjection{1.0f};
+
+            bool m_Captured{false};
+            LayerStatus m_Status;
+    };
+}
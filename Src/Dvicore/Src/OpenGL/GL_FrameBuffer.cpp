@@ -1,6 +1,10 @@
 #include "GL_FrameBuffer.hpp"
+#include "GL_StateCache.hpp"
+#include "GL_Renderer.hpp"
 #include "Assert.hpp"
 
+#include <algorithm>
+
 namespace DviCore 
 {
     FrameBuffer::FrameBuffer(const FrameBufferSpecifications& specification) 
@@ -9,65 +13,167 @@ namespace DviCore
 		CreateFrame();
     }
 
+    FrameBuffer::FrameBuffer(const FrameBufferSpecifications& specification, const std::shared_ptr<Texture>& color_target) 
+    {
+        DVIMANA_ASSERT(color_target->Width() == static_cast<int32_t>(specification.Width) && color_target->Height() == static_cast<int32_t>(specification.Height), 
+            "The color target doesn't match the frame's size!");
+
+        m_Specification = specification;
+        m_ColorTarget = color_target;
+        CreateFrame();
+    }
+
     FrameBuffer::~FrameBuffer() 
     {
-        glDeleteFramebuffers(1, &m_FrameBufferID);
-        glDeleteTextures(1, &m_DepthAttachment);
-        glDeleteTextures(1, &m_ColorAttachment);
+        DestroyFrame();
     }
 
+    // The frame constants carry the viewport size, screen-space effects measure pixels against the bound target.
     void FrameBuffer::Bind() const 
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, m_FrameBufferID);
-		glViewport(0, 0, m_Specification.Width, m_Specification.Height);
+        GLStateCache::BindFramebuffer(m_FrameBufferID);
+		Renderer::SetViewport(0, 0, m_Specification.Width, m_Specification.Height);
     }
 
     void FrameBuffer::Unbind() const 
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if(m_ResolveFrameBufferID != 0) 
+        {
+            glBlitNamedFramebuffer(m_FrameBufferID, m_ResolveFrameBufferID, 0, 0, m_Specification.Width, m_Specification.Height, 
+                0, 0, m_Specification.Width, m_Specification.Height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        }
+
+        GLStateCache::BindFramebuffer(0);
+    }
+
+    void FrameBuffer::SetSamples(uint32_t samples) 
+    {
+        samples = std::max(samples, 1u);
+        if(samples == m_Specification.Samples)
+            return;
+
+        DestroyFrame();
+        m_Specification.Samples = samples;
+        CreateFrame();
     }
 
     void FrameBuffer::ResizeFrame(uint32_t width, uint32_t height) 
     {
+        DVIMANA_ASSERT(m_ColorTarget == nullptr, "A frame rendering into a color target can't be resized!");
         m_Specification.Width = width;
 		m_Specification.Height = height;
 
-		glBindFramebuffer(GL_FRAMEBUFFER, m_FrameBufferID);
+        if(m_Specification.Samples > 1) 
+        {
+            DestroyFrame();
+            CreateFrame();
+            return;
+        }
 
-        glBindTexture(GL_TEXTURE_2D, m_ColorAttachment);
+		GLStateCache::BindFramebuffer(m_FrameBufferID);
+
+        GLStateCache::BindTexture(GL_TEXTURE_2D, m_ColorAttachment);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Specification.Width, m_Specification.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
 		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_ColorAttachment, 0);
 
-        glBindTexture(GL_TEXTURE_2D, m_DepthAttachment);
+        GLStateCache::BindTexture(GL_TEXTURE_2D, m_DepthAttachment);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, m_Specification.Width, m_Specification.Height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
         //glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH24_STENCIL8, m_Specification.Width, m_Specification.Height);
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, m_DepthAttachment, 0);
 
 		DVIMANA_ASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Framebuffer is incomplete!");
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		GLStateCache::BindFramebuffer(0);
     }
 
     void FrameBuffer::CreateFrame() 
     {
+        if(m_Specification.Samples > 1) 
+        {
+            CreateMultisampledFrame();
+            return;
+        }
+
         glCreateFramebuffers(1, &m_FrameBufferID);
-		glBindFramebuffer(GL_FRAMEBUFFER, m_FrameBufferID);
+		GLStateCache::BindFramebuffer(m_FrameBufferID);
 
-        glCreateTextures(GL_TEXTURE_2D, 1, &m_ColorAttachment);
-        glBindTexture(GL_TEXTURE_2D, m_ColorAttachment);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Specification.Width, m_Specification.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_ColorAttachment, 0);
+        if(m_ColorTarget != nullptr) 
+        {
+            m_ColorAttachment = m_ColorTarget->ID();
+            glNamedFramebufferTexture(m_FrameBufferID, GL_COLOR_ATTACHMENT0, m_ColorAttachment, 0);
+        }
+        else 
+        {
+            glCreateTextures(GL_TEXTURE_2D, 1, &m_ColorAttachment);
+            GLStateCache::BindTexture(GL_TEXTURE_2D, m_ColorAttachment);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Specification.Width, m_Specification.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_ColorAttachment, 0);
+        }
 
         glCreateTextures(GL_TEXTURE_2D, 1, &m_DepthAttachment);
-        glBindTexture(GL_TEXTURE_2D, m_DepthAttachment);
+        GLStateCache::BindTexture(GL_TEXTURE_2D, m_DepthAttachment);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, m_Specification.Width, m_Specification.Height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
         //glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH24_STENCIL8, m_Specification.Width, m_Specification.Height);
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, m_DepthAttachment, 0);
 
 		DVIMANA_ASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Framebuffer is incomplete!");
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		GLStateCache::BindFramebuffer(0);
+    }
+
+    // Renders into multisampled renderbuffers, the color attachment only receives the resolved frame.
+    void FrameBuffer::CreateMultisampledFrame() 
+    {
+        GLint max_samples = 0;
+        glGetIntegerv(GL_MAX_SAMPLES, &max_samples);
+        m_Specification.Samples = std::min(m_Specification.Samples, static_cast<uint32_t>(max_samples));
+
+        glCreateRenderbuffers(1, &m_ColorRenderbuffer);
+        glNamedRenderbufferStorageMultisample(m_ColorRenderbuffer, m_Specification.Samples, GL_RGBA8, m_Specification.Width, m_Specification.Height);
+
+        glCreateRenderbuffers(1, &m_DepthRenderbuffer);
+        glNamedRenderbufferStorageMultisample(m_DepthRenderbuffer, m_Specification.Samples, GL_DEPTH24_STENCIL8, m_Specification.Width, m_Specification.Height);
+
+        glCreateFramebuffers(1, &m_FrameBufferID);
+        glNamedFramebufferRenderbuffer(m_FrameBufferID, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorRenderbuffer);
+        glNamedFramebufferRenderbuffer(m_FrameBufferID, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthRenderbuffer);
+        DVIMANA_ASSERT(glCheckNamedFramebufferStatus(m_FrameBufferID, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Multisampled framebuffer is incomplete!");
+
+        if(m_ColorTarget != nullptr) 
+        {
+            m_ColorAttachment = m_ColorTarget->ID();
+        }
+        else 
+        {
+            glCreateTextures(GL_TEXTURE_2D, 1, &m_ColorAttachment);
+            glTextureStorage2D(m_ColorAttachment, 1, GL_RGBA8, m_Specification.Width, m_Specification.Height);
+            glTextureParameteri(m_ColorAttachment, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTextureParameteri(m_ColorAttachment, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTextureParameteri(m_ColorAttachment, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTextureParameteri(m_ColorAttachment, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+
+        glCreateFramebuffers(1, &m_ResolveFrameBufferID);
+        glNamedFramebufferTexture(m_ResolveFrameBufferID, GL_COLOR_ATTACHMENT0, m_ColorAttachment, 0);
+        DVIMANA_ASSERT(glCheckNamedFramebufferStatus(m_ResolveFrameBufferID, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Resolve framebuffer is incomplete!");
+    }
+
+    void FrameBuffer::DestroyFrame() 
+    {
+        GLStateCache::DeleteFramebuffer(m_FrameBufferID);
+        GLStateCache::DeleteTexture(m_DepthAttachment);
+        if(m_ColorTarget == nullptr)
+            GLStateCache::DeleteTexture(m_ColorAttachment);
+        m_FrameBufferID = m_DepthAttachment = m_ColorAttachment = 0;
+
+        if(m_ResolveFrameBufferID != 0) 
+        {
+            GLStateCache::DeleteFramebuffer(m_ResolveFrameBufferID);
+            glDeleteRenderbuffers(1, &m_ColorRenderbuffer);
+            glDeleteRenderbuffers(1, &m_DepthRenderbuffer);
+            m_ResolveFrameBufferID = m_ColorRenderbuffer = m_DepthRenderbuffer = 0;
+        }
     }
 }
\ No newline at end of file
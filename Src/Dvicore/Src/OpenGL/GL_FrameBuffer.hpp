@@ -1,25 +1,34 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <glad/glad.h>
 
+#include "GL_Texture.hpp"
+
 namespace DviCore 
 {
     struct FrameBufferSpecifications 
     {
         uint32_t Width{0}, Height{0};
+        uint32_t Samples{1};
         bool SwapChainTarget{false};
     };
 
+    // With more than one sample the frame renders into multisampled renderbuffers and Unbind resolves them into the color
+    // attachment, so GetColorAttachment always returns a single-sample texture.
+    // A frame given a color target renders (or resolves) into that texture instead of one of its own and can't be resized.
     class FrameBuffer 
     {
         public:
             FrameBuffer(const FrameBufferSpecifications& specification);
+            FrameBuffer(const FrameBufferSpecifications& specification, const std::shared_ptr<Texture>& color_target);
             ~FrameBuffer();
 
             void Bind() const;
             void Unbind() const;
             void ResizeFrame(uint32_t width, uint32_t height);
+            void SetSamples(uint32_t samples);
 
             uint32_t GetFrameBufferID() const { return m_FrameBufferID; }
             uint32_t GetColorAttachment() const { return m_ColorAttachment; }
@@ -27,12 +36,20 @@ namespace DviCore
 
         private:
             void CreateFrame();
+            void CreateMultisampledFrame();
+            void DestroyFrame();
 
         private:
             uint32_t m_FrameBufferID{0};
             uint32_t m_ColorAttachment{0};
             uint32_t m_DepthAttachment{0};
 
+            std::shared_ptr<Texture> m_ColorTarget{nullptr};
+
+            uint32_t m_ResolveFrameBufferID{0};
+            uint32_t m_ColorRenderbuffer{0};
+            uint32_t m_DepthRenderbuffer{0};
+
             FrameBufferSpecifications m_Specification;
     };
 }
\ No newline at end of file
@@ -0,0 +1,322 @@
+#include "GL_ParticleSystem.hpp"
+#include "Instrument.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define DVIMANA_PARTICLE_KERNEL_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #define DVIMANA_TARGET(isa)
+    #else
+        #define DVIMANA_TARGET(isa) __attribute__((target(isa)))
+    #endif
+#endif
+
+namespace DviCore
+{
+    struct ParticleStreams
+    {
+        float* PositionX{nullptr};
+        float* PositionY{nullptr};
+        float* VelocityX{nullptr};
+        float* VelocityY{nullptr};
+        float* ColorR{nullptr};
+        float* ColorG{nullptr};
+        float* ColorB{nullptr};
+        float* ColorA{nullptr};
+        float* Life{nullptr};
+        const float* InverseLifetime{nullptr};
+    };
+
+    struct ParticleStep
+    {
+        float DeltaTime{0.0f};
+        glm::vec2 Gravity{0.0f};
+        glm::vec4 ColorEnd{0.0f};
+        glm::vec4 ColorRange{0.0f};
+    };
+
+    // Every backend runs the same operations in the same order, without fused multiply-adds, so the results are bit-identical:
+    // v += g * dt, p += v * dt, life -= dt, color = end + (begin - end) * max(life / lifetime, 0).
+    static void SimulateScalar(const ParticleStreams& streams, size_t first, size_t last, const ParticleStep& step)
+    {
+        float dt = step.DeltaTime;
+        for(size_t i = first; i < last; i++)
+        {
+            float velocity_x = streams.VelocityX[i] + step.Gravity.x * dt;
+            float velocity_y = streams.VelocityY[i] + step.Gravity.y * dt;
+            streams.VelocityX[i] = velocity_x;
+            streams.VelocityY[i] = velocity_y;
+            streams.PositionX[i] += velocity_x * dt;
+            streams.PositionY[i] += velocity_y * dt;
+
+            float life = streams.Life[i] - dt;
+            float t = std::max(life * streams.InverseLifetime[i], 0.0f);
+            streams.Life[i] = life;
+            streams.ColorR[i] = step.ColorEnd.r + step.ColorRange.r * t;
+            streams.ColorG[i] = step.ColorEnd.g + step.ColorRange.g * t;
+            streams.ColorB[i] = step.ColorEnd.b + step.ColorRange.b * t;
+            streams.ColorA[i] = step.ColorEnd.a + step.ColorRange.a * t;
+        }
+    }
+
+#ifdef DVIMANA_PARTICLE_KERNEL_X86
+
+    DVIMANA_TARGET("sse2")
+    static void SimulateSSE2(const ParticleStreams& streams, size_t first, size_t last, const ParticleStep& step)
+    {
+        const __m128 dt = _mm_set1_ps(step.DeltaTime);
+        const __m128 gravity_x = _mm_set1_ps(step.Gravity.x * step.DeltaTime);
+        const __m128 gravity_y = _mm_set1_ps(step.Gravity.y * step.DeltaTime);
+        const __m128 zero = _mm_setzero_ps();
+
+        size_t i = first;
+        for(; i + 4 <= last; i += 4)
+        {
+            __m128 velocity_x = _mm_add_ps(_mm_loadu_ps(streams.VelocityX + i), gravity_x);
+            __m128 velocity_y = _mm_add_ps(_mm_loadu_ps(streams.VelocityY + i), gravity_y);
+            _mm_storeu_ps(streams.VelocityX + i, velocity_x);
+            _mm_storeu_ps(streams.VelocityY + i, velocity_y);
+            _mm_storeu_ps(streams.PositionX + i, _mm_add_ps(_mm_loadu_ps(streams.PositionX + i), _mm_mul_ps(velocity_x, dt)));
+            _mm_storeu_ps(streams.PositionY + i, _mm_add_ps(_mm_loadu_ps(streams.PositionY + i), _mm_mul_ps(velocity_y, dt)));
+
+            __m128 life = _mm_sub_ps(_mm_loadu_ps(streams.Life + i), dt);
+            __m128 t = _mm_max_ps(_mm_mul_ps(life, _mm_loadu_ps(streams.InverseLifetime + i)), zero);
+            _mm_storeu_ps(streams.Life + i, life);
+            _mm_storeu_ps(streams.ColorR + i, _mm_add_ps(_mm_set1_ps(step.ColorEnd.r), _mm_mul_ps(_mm_set1_ps(step.ColorRange.r), t)));
+            _mm_storeu_ps(streams.ColorG + i, _mm_add_ps(_mm_set1_ps(step.ColorEnd.g), _mm_mul_ps(_mm_set1_ps(step.ColorRange.g), t)));
+            _mm_storeu_ps(streams.ColorB + i, _mm_add_ps(_mm_set1_ps(step.ColorEnd.b), _mm_mul_ps(_mm_set1_ps(step.ColorRange.b), t)));
+            _mm_storeu_ps(streams.ColorA + i, _mm_add_ps(_mm_set1_ps(step.ColorEnd.a), _mm_mul_ps(_mm_set1_ps(step.ColorRange.a), t)));
+        }
+
+        SimulateScalar(streams, i, last, step);
+    }
+
+    DVIMANA_TARGET("avx2")
+    static void SimulateAVX2(const ParticleStreams& streams, size_t first, size_t last, const ParticleStep& step)
+    {
+        const __m256 dt = _mm256_set1_ps(step.DeltaTime);
+        const __m256 gravity_x = _mm256_set1_ps(step.Gravity.x * step.DeltaTime);
+        const __m256 gravity_y = _mm256_set1_ps(step.Gravity.y * step.DeltaTime);
+        const __m256 zero = _mm256_setzero_ps();
+
+        size_t i = first;
+        for(; i + 8 <= last; i += 8)
+        {
+            __m256 velocity_x = _mm256_add_ps(_mm256_loadu_ps(streams.VelocityX + i), gravity_x);
+            __m256 velocity_y = _mm256_add_ps(_mm256_loadu_ps(streams.VelocityY + i), gravity_y);
+            _mm256_storeu_ps(streams.VelocityX + i, velocity_x);
+            _mm256_storeu_ps(streams.VelocityY + i, velocity_y);
+            _mm256_storeu_ps(streams.PositionX + i, _mm256_add_ps(_mm256_loadu_ps(streams.PositionX + i), _mm256_mul_ps(velocity_x, dt)));
+            _mm256_storeu_ps(streams.PositionY + i, _mm256_add_ps(_mm256_loadu_ps(streams.PositionY + i), _mm256_mul_ps(velocity_y, dt)));
+
+            __m256 life = _mm256_sub_ps(_mm256_loadu_ps(streams.Life + i), dt);
+            __m256 t = _mm256_max_ps(_mm256_mul_ps(life, _mm256_loadu_ps(streams.InverseLifetime + i)), zero);
+            _mm256_storeu_ps(streams.Life + i, life);
+            _mm256_storeu_ps(streams.ColorR + i, _mm256_add_ps(_mm256_set1_ps(step.ColorEnd.r), _mm256_mul_ps(_mm256_set1_ps(step.ColorRange.r), t)));
+            _mm256_storeu_ps(streams.ColorG + i, _mm256_add_ps(_mm256_set1_ps(step.ColorEnd.g), _mm256_mul_ps(_mm256_set1_ps(step.ColorRange.g), t)));
+            _mm256_storeu_ps(streams.ColorB + i, _mm256_add_ps(_mm256_set1_ps(step.ColorEnd.b), _mm256_mul_ps(_mm256_set1_ps(step.ColorRange.b), t)));
+            _mm256_storeu_ps(streams.ColorA + i, _mm256_add_ps(_mm256_set1_ps(step.ColorEnd.a), _mm256_mul_ps(_mm256_set1_ps(step.ColorRange.a), t)));
+        }
+
+        SimulateScalar(streams, i, last, step);
+    }
+
+#endif
+
+    using SimulateFunction = void(*)(const ParticleStreams&, size_t, size_t, const ParticleStep&);
+
+    static SimulateFunction BackendFunction(QuadKernelBackend backend)
+    {
+        switch(backend)
+        {
+#ifdef DVIMANA_PARTICLE_KERNEL_X86
+            case QuadKernelBackend::AVX2: return SimulateAVX2;
+            case QuadKernelBackend::SSE2: return SimulateSSE2;
+#endif
+            default: return SimulateScalar;
+        }
+    }
+
+    ParticleSystem::ParticleSystem(const ParticleSystemSpecifications& specification)
+        : m_Specification(specification)
+    {
+        Resize(m_Specification.MaxParticles);
+    }
+
+    void ParticleSystem::Resize(size_t capacity)
+    {
+        for(std::vector<float>* stream : { &m_PositionX, &m_PositionY, &m_VelocityX, &m_VelocityY, &m_ColorR, &m_ColorG, &m_ColorB, &m_ColorA, &m_Life, &m_InverseLifetime })
+            stream->resize(capacity);
+    }
+
+    void ParticleSystem::Emit(const glm::vec2& origin, uint32_t count)
+    {
+        const ParticleSystemSpecifications& spec = m_Specification;
+        if(m_PositionX.size() < spec.MaxParticles)
+            Resize(spec.MaxParticles);
+
+        count = static_cast<uint32_t>(std::min<size_t>(count, spec.MaxParticles > m_Count ? spec.MaxParticles - m_Count : 0));
+        std::uniform_real_distribution<float> variation(-0.5f, 0.5f);
+        for(uint32_t n = 0; n < count; n++, m_Count++)
+        {
+            float lifetime = std::max(spec.Lifetime + spec.LifetimeVariation * variation(m_Random), 0.01f);
+            m_PositionX[m_Count] = origin.x;
+            m_PositionY[m_Count] = origin.y;
+            m_VelocityX[m_Count] = spec.Velocity.x + spec.VelocityVariation.x * variation(m_Random);
+            m_VelocityY[m_Count] = spec.Velocity.y + spec.VelocityVariation.y * variation(m_Random);
+            m_ColorR[m_Count] = spec.ColorBegin.r;
+            m_ColorG[m_Count] = spec.ColorBegin.g;
+            m_ColorB[m_Count] = spec.ColorBegin.b;
+            m_ColorA[m_Count] = spec.ColorBegin.a;
+            m_Life[m_Count] = lifetime;
+            m_InverseLifetime[m_Count] = 1.0f / lifetime;
+        }
+
+        m_Status.Emitted += count;
+    }
+
+    size_t ParticleSystem::JobCount() const
+    {
+        return std::max<size_t>(1, std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), m_Count / PARTICLES_PER_JOB));
+    }
+
+    void ParticleSystem::Update(TimeSteps delta_time, const glm::vec2& origin)
+    {
+        DVI_PROFILE_SCOPE("ParticleSystem::Update");
+        auto start = std::chrono::steady_clock::now();
+
+        m_EmitRemainder += m_Specification.EmissionRate * delta_time;
+        uint32_t emit = static_cast<uint32_t>(m_EmitRemainder);
+        m_EmitRemainder -= emit;
+        Emit(origin, emit);
+
+        ParticleStreams streams{ m_PositionX.data(), m_PositionY.data(), m_VelocityX.data(), m_VelocityY.data(),
+            m_ColorR.data(), m_ColorG.data(), m_ColorB.data(), m_ColorA.data(), m_Life.data(), m_InverseLifetime.data() };
+
+        ParticleStep step;
+        step.DeltaTime = delta_time;
+        step.Gravity = m_Specification.Gravity;
+        step.ColorEnd = m_Specification.ColorEnd;
+        step.ColorRange = m_Specification.ColorBegin - m_Specification.ColorEnd;
+
+        SimulateFunction simulate = BackendFunction(QuadKernel::GetBackend());
+        size_t jobs = JobCount();
+        if(jobs <= 1)
+        {
+            simulate(streams, 0, m_Count, step);
+        }
+        else
+        {
+            // Slices are rounded to whole AVX2 lanes so only the last one runs a scalar tail.
+            size_t slice = ((m_Count + jobs - 1) / jobs + 7) & ~static_cast<size_t>(7);
+            std::vector<std::future<void>> futures;
+            for(size_t first = 0; first < m_Count; first += slice)
+            {
+                size_t last = std::min(first + slice, m_Count);
+                futures.push_back(std::async(std::launch::async, simulate, std::cref(streams), first, last, std::cref(step)));
+            }
+
+            for(std::future<void>& future : futures)
+                future.wait();
+        }
+
+        Compact();
+        std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        m_Status.UpdateTime += elapsed.count();
+    }
+
+    // Swap-remove, the last live particle fills every hole, so the live range stays dense without shifting the arrays.
+    void ParticleSystem::Compact()
+    {
+        size_t i = 0;
+        while(i < m_Count)
+        {
+            if(m_Life[i] > 0.0f)
+            {
+                i++;
+                continue;
+            }
+
+            size_t last = --m_Count;
+            m_PositionX[i] = m_PositionX[last];
+            m_PositionY[i] = m_PositionY[last];
+            m_VelocityX[i] = m_VelocityX[last];
+            m_VelocityY[i] = m_VelocityY[last];
+            m_ColorR[i] = m_ColorR[last];
+            m_ColorG[i] = m_ColorG[last];
+            m_ColorB[i] = m_ColorB[last];
+            m_ColorA[i] = m_ColorA[last];
+            m_Life[i] = m_Life[last];
+            m_InverseLifetime[i] = m_InverseLifetime[last];
+            m_Status.Died++;
+        }
+    }
+
+    void ParticleSystem::Draw(float depth)
+    {
+        DVI_PROFILE_SCOPE("ParticleSystem::Draw");
+        auto start = std::chrono::steady_clock::now();
+
+        float size_end = m_Specification.SizeEnd;
+        float size_range = m_Specification.SizeBegin - m_Specification.SizeEnd;
+        auto particle = [&](size_t i, glm::vec3& position, glm::vec2& size, glm::vec4& color)
+        {
+            position = { m_PositionX[i], m_PositionY[i], depth };
+            size = glm::vec2(size_end + size_range * (m_Life[i] * m_InverseLifetime[i]));
+            color = { m_ColorR[i], m_ColorG[i], m_ColorB[i], m_ColorA[i] };
+        };
+
+        // Recorded batches bypass the sort queue, sorted frames submit on this thread.
+        size_t jobs = JobCount();
+        if(jobs <= 1 || BatchRenderer::GetQueueSorting())
+        {
+            glm::vec3 position;
+            glm::vec2 size;
+            glm::vec4 color;
+            for(size_t i = 0; i < m_Count; i++)
+            {
+                particle(i, position, size, color);
+                BatchRenderer::Quad(position, size, color);
+            }
+        }
+        else
+        {
+            m_Recorders.resize(jobs);
+            size_t slice = (m_Count + jobs - 1) / jobs;
+            std::vector<std::future<void>> futures;
+            for(size_t job = 0; job < jobs; job++)
+            {
+                size_t first = job * slice;
+                size_t last = std::min(first + slice, m_Count);
+                futures.push_back(std::async(std::launch::async, [this, &particle, job, first, last]()
+                {
+                    BatchRecorder& recorder = m_Recorders[job];
+                    recorder.Reset();
+
+                    glm::vec3 position;
+                    glm::vec2 size;
+                    glm::vec4 color;
+                    for(size_t i = first; i < last; i++)
+                    {
+                        particle(i, position, size, color);
+                        recorder.Quad(position, size, color);
+                    }
+                }));
+            }
+
+            for(size_t job = 0; job < jobs; job++)
+            {
+                futures[job].wait();
+                BatchRenderer::Merge(m_Recorders[job]);
+            }
+        }
+
+        std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        m_Status.DrawTime += elapsed.count();
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "GL_Renderer.hpp"
+#include "TimeSteps.hpp"
+
+namespace DviCore
+{
+    struct ParticleSystemSpecifications
+    {
+        uint32_t MaxParticles{100000};
+        float EmissionRate{1000.0f};
+        float Lifetime{2.0f};
+        float LifetimeVariation{0.5f};
+        glm::vec2 Velocity{0.0f, 2.0f};
+        glm::vec2 VelocityVariation{1.0f, 1.0f};
+        glm::vec2 Gravity{0.0f, -1.0f};
+        glm::vec4 ColorBegin{1.0f, 1.0f, 1.0f, 1.0f};
+        glm::vec4 ColorEnd{1.0f, 1.0f, 1.0f, 0.0f};
+        float SizeBegin{0.1f};
+        float SizeEnd{0.0f};
+    };
+
+    // Particles live in structure-of-arrays form, one tightly packed array per attribute, so the update kernel streams through
+    // them with full SIMD lanes. Live particles are always the first Count() entries, dead ones are swap-removed after every
+    // update. The kernel follows QuadKernel's backend, large systems are split across worker threads both for the update
+    // and for recording their quads.
+    class ParticleSystem
+    {
+        public:
+            static const size_t PARTICLES_PER_JOB = 65536;
+
+            ParticleSystem(const ParticleSystemSpecifications& specification = ParticleSystemSpecifications());
+            ~ParticleSystem() = default;
+
+            void Emit(const glm::vec2& origin, uint32_t count);
+            void Update(TimeSteps delta_time, const glm::vec2& origin);
+            void Clear() { m_Count = 0; }
+
+            // Submits one quad per live particle to the current batch.
+            void Draw(float depth = 0.0f);
+
+            ParticleSystemSpecifications& GetSpecification() { return m_Specification; }
+            size_t Count() const { return m_Count; }
+
+            struct ParticleStatus
+            {
+                uint32_t Emitted{0};
+                uint32_t Died{0};
+                float UpdateTime{0.0f};
+                float DrawTime{0.0f};
+            };
+
+            const ParticleStatus& Status() const { return m_Status; }
+            void StatusReset() { m_Status = ParticleStatus(); }
+
+        private:
+            void Resize(size_t capacity);
+            void Compact();
+            size_t JobCount() const;
+
+        private:
+            ParticleSystemSpecifications m_Specification;
+            size_t m_Count{0};
+            float m_EmitRemainder{0.0f};
+
+            std::vector<float> m_PositionX, m_PositionY;
+            std::vector<float> m_VelocityX, m_VelocityY;
+            std::vector<float> m_ColorR, m_ColorG, m_ColorB, m_ColorA;
+            std::vector<float> m_Life, m_InverseLifetime;
+
+            std::mt19937 m_Random{std::random_device{}()};
+            std::vector<BatchRecorder> m_Recorders;
+            ParticleStatus m_Status;
+    };
+}
@@ -0,0 +1,321 @@
+#include "GL_QuadKernel.hpp"
+#include "Platform.hpp"
+#include "Log.hpp"
+
+#include <cmath>
+#include <array>
+#include <random>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define DVIMANA_QUAD_KERNEL_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define DVIMANA_TARGET(isa)
+    #else
+        #define DVIMANA_TARGET(isa) __attribute__((target(isa)))
+    #endif
+#endif
+
+namespace DviCore 
+{
+    static_assert(sizeof(QuadAffine) == sizeof(float) * 9, "QuadAffine must stay tightly packed!");
+
+    static const glm::vec2 CORNER_OFFSETS[4] = { { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f } };
+
+    // The scalar and SIMD backends evaluate the corners with the same operation order so their results are bit-identical:
+    // c0 = (T - hx) - hy, c1 = (T + hx) - hy, c2 = (T + hx) + hy, c3 = (T - hx) + hy with hx = AxisX * 0.5, hy = AxisY * 0.5.
+    static void CornersScalar(const QuadAffine* quads, size_t count, glm::vec3* corners) 
+    {
+        for(size_t i = 0; i < count; i++) 
+        {
+            const QuadAffine& quad = quads[i];
+            for(int axis = 0; axis < 3; axis++) 
+            {
+                float hx = quad.AxisX[axis] * 0.5f;
+                float hy = quad.AxisY[axis] * 0.5f;
+                float t = quad.Translation[axis];
+
+                corners[i * 4 + 0][axis] = (t - hx) - hy;
+                corners[i * 4 + 1][axis] = (t + hx) - hy;
+                corners[i * 4 + 2][axis] = (t + hx) + hy;
+                corners[i * 4 + 3][axis] = (t - hx) + hy;
+            }
+        }
+    }
+
+    // The glm matrix product the kernels replace, kept as a baseline for benchmarks and the self-check.
+    static void CornersReference(const QuadAffine* quads, size_t count, glm::vec3* corners) 
+    {
+        for(size_t i = 0; i < count; i++) 
+        {
+            const QuadAffine& quad = quads[i];
+            glm::mat4 transform(glm::vec4(quad.AxisX, 0.0f), glm::vec4(quad.AxisY, 0.0f), glm::vec4(0.0f, 0.0f, 1.0f, 0.0f), glm::vec4(quad.Translation, 1.0f));
+            for(int corner = 0; corner < 4; corner++)
+                corners[i * 4 + corner] = glm::vec3(transform * glm::vec4(CORNER_OFFSETS[corner], 0.0f, 1.0f));
+        }
+    }
+
+#ifdef DVIMANA_QUAD_KERNEL_X86
+
+    // One quad per 128-bit lane: the nine input floats arrive as (ax ay az bx)(by bz tx ty)(tz), the corners are computed
+    // as xyz_ vectors and repacked into the twelve output floats (x0 y0 z0 x1)(y1 z1 x2 y2)(z2 x3 y3 z3).
+    DVIMANA_TARGET("sse2")
+    static void CornersSSE2(const QuadAffine* quads, size_t count, glm::vec3* corners) 
+    {
+        const float* in = reinterpret_cast<const float*>(quads);
+        float* out = reinterpret_cast<float*>(corners);
+        const __m128 half = _mm_set1_ps(0.5f);
+
+        for(size_t i = 0; i < count; i++, in += 9, out += 12) 
+        {
+            __m128 q0 = _mm_loadu_ps(in);
+            __m128 q1 = _mm_loadu_ps(in + 4);
+            __m128 q2 = _mm_load_ss(in + 8);
+
+            __m128 axis_y   = _mm_shuffle_ps(q0, q1, _MM_SHUFFLE(1, 0, 3, 3));
+            axis_y          = _mm_shuffle_ps(axis_y, axis_y, _MM_SHUFFLE(3, 3, 2, 0));
+            __m128 t        = _mm_shuffle_ps(q1, q2, _MM_SHUFFLE(0, 0, 3, 2));
+
+            __m128 hx = _mm_mul_ps(q0, half);
+            __m128 hy = _mm_mul_ps(axis_y, half);
+            __m128 c0 = _mm_sub_ps(_mm_sub_ps(t, hx), hy);
+            __m128 c1 = _mm_sub_ps(_mm_add_ps(t, hx), hy);
+            __m128 c2 = _mm_add_ps(_mm_add_ps(t, hx), hy);
+            __m128 c3 = _mm_add_ps(_mm_sub_ps(t, hx), hy);
+
+            _mm_storeu_ps(out + 0, _mm_shuffle_ps(c0, _mm_shuffle_ps(c0, c1, _MM_SHUFFLE(0, 0, 2, 2)), _MM_SHUFFLE(2, 0, 1, 0)));
+            _mm_storeu_ps(out + 4, _mm_shuffle_ps(c1, c2, _MM_SHUFFLE(1, 0, 2, 1)));
+            _mm_storeu_ps(out + 8, _mm_shuffle_ps(_mm_shuffle_ps(c2, c3, _MM_SHUFFLE(0, 0, 2, 2)), c3, _MM_SHUFFLE(2, 1, 2, 0)));
+        }
+    }
+
+    // Same lane layout as the SSE2 path with two quads per iteration, one in each 128-bit half.
+    DVIMANA_TARGET("avx2")
+    static inline __m256 LoadPairAVX2(const float* low, const float* high) 
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+    }
+
+    DVIMANA_TARGET("avx2")
+    static void CornersAVX2(const QuadAffine* quads, size_t count, glm::vec3* corners) 
+    {
+        const float* in = reinterpret_cast<const float*>(quads);
+        float* out = reinterpret_cast<float*>(corners);
+        const __m256 half = _mm256_set1_ps(0.5f);
+
+        size_t i = 0;
+        for(; i + 2 <= count; i += 2, in += 18, out += 24) 
+        {
+            __m256 q0 = LoadPairAVX2(in, in + 9);
+            __m256 q1 = LoadPairAVX2(in + 4, in + 13);
+            __m256 q2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ss(in + 8)), _mm_load_ss(in + 17), 1);
+
+            __m256 axis_y   = _mm256_shuffle_ps(q0, q1, _MM_SHUFFLE(1, 0, 3, 3));
+            axis_y          = _mm256_shuffle_ps(axis_y, axis_y, _MM_SHUFFLE(3, 3, 2, 0));
+            __m256 t        = _mm256_shuffle_ps(q1, q2, _MM_SHUFFLE(0, 0, 3, 2));
+
+            __m256 hx = _mm256_mul_ps(q0, half);
+            __m256 hy = _mm256_mul_ps(axis_y, half);
+            __m256 c0 = _mm256_sub_ps(_mm256_sub_ps(t, hx), hy);
+            __m256 c1 = _mm256_sub_ps(_mm256_add_ps(t, hx), hy);
+            __m256 c2 = _mm256_add_ps(_mm256_add_ps(t, hx), hy);
+            __m256 c3 = _mm256_add_ps(_mm256_sub_ps(t, hx), hy);
+
+            __m256 out0 = _mm256_shuffle_ps(c0, _mm256_shuffle_ps(c0, c1, _MM_SHUFFLE(0, 0, 2, 2)), _MM_SHUFFLE(2, 0, 1, 0));
+            __m256 out1 = _mm256_shuffle_ps(c1, c2, _MM_SHUFFLE(1, 0, 2, 1));
+            __m256 out2 = _mm256_shuffle_ps(_mm256_shuffle_ps(c2, c3, _MM_SHUFFLE(0, 0, 2, 2)), c3, _MM_SHUFFLE(2, 1, 2, 0));
+
+            _mm_storeu_ps(out + 0,  _mm256_castps256_ps128(out0));
+            _mm_storeu_ps(out + 4,  _mm256_castps256_ps128(out1));
+            _mm_storeu_ps(out + 8,  _mm256_castps256_ps128(out2));
+            _mm_storeu_ps(out + 12, _mm256_extractf128_ps(out0, 1));
+            _mm_storeu_ps(out + 16, _mm256_extractf128_ps(out1, 1));
+            _mm_storeu_ps(out + 20, _mm256_extractf128_ps(out2, 1));
+        }
+
+        CornersScalar(quads + i, count - i, corners + i * 4);
+    }
+
+    static bool CPUSupportsAVX2() 
+    {
+#if defined(_MSC_VER)
+        int info[4]{};
+        __cpuid(info, 0);
+        if(info[0] < 7)
+            return false;
+
+        __cpuid(info, 1);
+        bool os_saves_ymm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 0x6) == 0x6);
+        __cpuidex(info, 7, 0);
+        return os_saves_ymm && (info[1] & (1 << 5));
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    static bool CPUSupportsSSE2() 
+    {
+#if defined(_MSC_VER)
+        int info[4]{};
+        __cpuid(info, 1);
+        return info[3] & (1 << 26);
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+#endif
+    }
+
+#endif
+
+    using CornersFunction = void(*)(const QuadAffine*, size_t, glm::vec3*);
+
+    static QuadKernelBackend BestBackend() 
+    {
+#ifdef DVIMANA_QUAD_KERNEL_X86
+        if(CPUSupportsAVX2())
+            return QuadKernelBackend::AVX2;
+        if(CPUSupportsSSE2())
+            return QuadKernelBackend::SSE2;
+#endif
+        return QuadKernelBackend::Scalar;
+    }
+
+    static CornersFunction BackendFunction(QuadKernelBackend backend) 
+    {
+        switch(backend) 
+        {
+#ifdef DVIMANA_QUAD_KERNEL_X86
+            case QuadKernelBackend::AVX2: return CornersAVX2;
+            case QuadKernelBackend::SSE2: return CornersSSE2;
+#endif
+            case QuadKernelBackend::Reference: return CornersReference;
+            default: return CornersScalar;
+        }
+    }
+
+    static const char* BackendName(QuadKernelBackend backend) 
+    {
+        switch(backend) 
+        {
+            case QuadKernelBackend::Scalar: return "Scalar";
+            case QuadKernelBackend::SSE2: return "SSE2";
+            case QuadKernelBackend::AVX2: return "AVX2";
+            case QuadKernelBackend::Reference: return "Reference";
+            default: return "Unknown";
+        }
+    }
+
+    static QuadKernelBackend s_Backend = BestBackend();
+    static bool s_Checked = false;
+    static bool s_CheckPassed = false;
+    static CornersFunction s_Corners = BackendFunction(s_Backend);
+
+    QuadAffine QuadKernel::Affine(const glm::vec3& position, const glm::vec2& size, float rotation) 
+    {
+        float c = std::cos(rotation);
+        float s = std::sin(rotation);
+
+        QuadAffine quad;
+        quad.AxisX          = { c * size.x, s * size.x, 0.0f };
+        quad.AxisY          = { -s * size.y, c * size.y, 0.0f };
+        quad.Translation    = position;
+        return quad;
+    }
+
+    QuadAffine QuadKernel::Affine(const glm::mat4& transform) 
+    {
+        QuadAffine quad;
+        quad.AxisX          = transform[0];
+        quad.AxisY          = transform[1];
+        quad.Translation    = transform[3];
+        return quad;
+    }
+
+    void QuadKernel::Corners(const QuadAffine* quads, size_t count, glm::vec3* corners) 
+    {
+        s_Corners(quads, count, corners);
+    }
+
+    QuadKernelBackend QuadKernel::GetBackend() 
+    {
+        return s_Backend;
+    }
+
+    bool QuadKernel::SetBackend(QuadKernelBackend backend) 
+    {
+        if(!Supported(backend))
+            return false;
+
+        s_Backend = backend;
+        s_Corners = BackendFunction(backend);
+        return true;
+    }
+
+    bool QuadKernel::Supported(QuadKernelBackend backend) 
+    {
+        switch(backend) 
+        {
+#ifdef DVIMANA_QUAD_KERNEL_X86
+            case QuadKernelBackend::AVX2: return CPUSupportsAVX2();
+            case QuadKernelBackend::SSE2: return CPUSupportsSSE2();
+#endif
+            case QuadKernelBackend::Scalar: return true;
+            case QuadKernelBackend::Reference: return true;
+            default: return false;
+        }
+    }
+
+    bool QuadKernel::SelfCheck() 
+    {
+        if(s_Checked)
+            return s_CheckPassed;
+
+        // An odd count so the AVX2 path also runs its scalar tail.
+        constexpr size_t count = 65;
+        std::mt19937 generator(1337);
+        std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+
+        std::array<QuadAffine, count> quads;
+        std::array<glm::vec3, count * 4> expected;
+        for(size_t i = 0; i < count; i++) 
+        {
+            glm::mat4 transform;
+            for(int column = 0; column < 4; column++)
+                for(int row = 0; row < 4; row++)
+                    transform[column][row] = distribution(generator);
+
+            quads[i] = Affine(transform);
+            for(int corner = 0; corner < 4; corner++)
+                expected[i * 4 + corner] = glm::vec3(transform * glm::vec4(CORNER_OFFSETS[corner], 0.0f, 1.0f));
+        }
+
+        bool passed = true;
+        std::array<glm::vec3, count * 4> corners;
+        for(QuadKernelBackend backend : { QuadKernelBackend::Scalar, QuadKernelBackend::SSE2, QuadKernelBackend::AVX2, QuadKernelBackend::Reference }) 
+        {
+            if(!Supported(backend))
+                continue;
+
+            BackendFunction(backend)(quads.data(), count, corners.data());
+            for(size_t i = 0; i < corners.size(); i++) 
+            {
+                float tolerance = 1e-5f * (1.0f + std::abs(expected[i].x) + std::abs(expected[i].y) + std::abs(expected[i].z));
+                glm::vec3 error = glm::abs(corners[i] - expected[i]);
+                if(error.x > tolerance || error.y > tolerance || error.z > tolerance) 
+                {
+                    DVI_CORE_ERROR("Corner kernel {0} disagrees with glm at corner {1}, it shouldn't be used", BackendName(backend), i);
+                    passed = false;
+                    if(s_Backend == backend)
+                        SetBackend(QuadKernelBackend::Scalar);
+                    break;
+                }
+            }
+        }
+
+        s_Checked = true;
+        s_CheckPassed = passed;
+        return passed;
+    }
+}
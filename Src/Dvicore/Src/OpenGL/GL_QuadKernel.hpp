@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace DviCore 
+{
+    struct QuadAffine 
+    {
+        glm::vec3 AxisX{1.0f, 0.0f, 0.0f};
+        glm::vec3 AxisY{0.0f, 1.0f, 0.0f};
+        glm::vec3 Translation{0.0f, 0.0f, 0.0f};
+    };
+
+    enum class QuadKernelBackend 
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+        Reference,
+    };
+
+    class QuadKernel 
+    {
+        private:
+            QuadKernel() = default;
+            ~QuadKernel() = default;
+
+        public:
+            static QuadAffine Affine(const glm::vec3& position, const glm::vec2& size, float rotation);
+            static QuadAffine Affine(const glm::mat4& transform);
+
+            static void Corners(const QuadAffine* quads, size_t count, glm::vec3* corners);
+
+            static QuadKernelBackend GetBackend();
+            static bool SetBackend(QuadKernelBackend backend);
+            static bool Supported(QuadKernelBackend backend);
+
+            // Compares every supported backend with glm's transform * vec4(corner, 0, 1) on random matrices, once per process.
+            // A backend that disagrees is logged and, if it was the active one, replaced by the scalar kernel.
+            static bool SelfCheck();
+    };
+}
@@ -0,0 +1,84 @@
+#include "GL_RenderQueue.hpp"
+
+#include <cstring>
+
+namespace DviCore
+{
+    static const uint32_t RADIX_BITS    = 8;
+    static const uint32_t RADIX_BUCKETS = 1 << RADIX_BITS;
+    static const uint32_t RADIX_PASSES  = 64 / RADIX_BITS;
+
+    // Maps a float onto an unsigned integer with the same ordering, negative values included.
+    static uint32_t SortableDepth(float depth)
+    {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &depth, sizeof(bits));
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
+
+    uint64_t RenderQueue::Key(uint8_t layer, bool translucent, uint8_t material, uint16_t texture, float depth)
+    {
+        uint64_t key = static_cast<uint64_t>(layer) << 55;
+        uint64_t order = SortableDepth(depth);
+
+        if(!translucent)
+            return key | (static_cast<uint64_t>(material & 0x7f) << 48) | (static_cast<uint64_t>(texture) << 32) | order;
+
+        key |= 1ull << 63;
+        key |= static_cast<uint64_t>(~static_cast<uint32_t>(order)) << 23;
+        return key | (static_cast<uint64_t>(material & 0x7f) << 16) | texture;
+    }
+
+    void RenderQueue::Push(uint64_t key)
+    {
+        m_Items.push_back({ key, static_cast<uint32_t>(m_Items.size()) });
+    }
+
+    void RenderQueue::Clear()
+    {
+        m_Items.clear();
+    }
+
+    // LSD radix sort over 8-bit digits, stable so equal keys keep their submission order. Digits every key shares are skipped.
+    const std::vector<uint32_t>& RenderQueue::Sort()
+    {
+        size_t count = m_Items.size();
+        m_Scratch.resize(count);
+
+        uint32_t histograms[RADIX_PASSES][RADIX_BUCKETS]{};
+        for(const Item& item : m_Items)
+        {
+            for(uint32_t pass = 0; pass < RADIX_PASSES; pass++)
+                histograms[pass][(item.Key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+        }
+
+        Item* source = m_Items.data();
+        Item* destination = m_Scratch.data();
+        for(uint32_t pass = 0; pass < RADIX_PASSES; pass++)
+        {
+            uint32_t* histogram = histograms[pass];
+            uint32_t shift = pass * RADIX_BITS;
+            if(count == 0 || histogram[(source[0].Key >> shift) & (RADIX_BUCKETS - 1)] == count)
+                continue;
+
+            uint32_t offset = 0;
+            for(uint32_t bucket = 0; bucket < RADIX_BUCKETS; bucket++)
+            {
+                uint32_t bucket_count = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucket_count;
+            }
+
+            for(size_t i = 0; i < count; i++)
+                destination[histogram[(source[i].Key >> shift) & (RADIX_BUCKETS - 1)]++] = source[i];
+
+            std::swap(source, destination);
+        }
+
+        m_Order.resize(count);
+        for(size_t i = 0; i < count; i++)
+            m_Order[i] = source[i].Index;
+
+        return m_Order;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace DviCore
+{
+    // Keys sort from the most significant bit down: every opaque item before any translucent one, then layer. Opaque items
+    // continue with material, texture and front-to-back depth so batches stay long, translucent ones with back-to-front
+    // depth first so blending stays correct.
+    class RenderQueue
+    {
+        public:
+            RenderQueue() = default;
+            ~RenderQueue() = default;
+
+            static uint64_t Key(uint8_t layer, bool translucent, uint8_t material, uint16_t texture, float depth);
+            static bool Translucent(uint64_t key) { return (key >> 63) != 0; }
+
+            void Push(uint64_t key);
+            void Clear();
+
+            const std::vector<uint32_t>& Sort();
+            size_t Size() const { return m_Items.size(); }
+
+        private:
+            struct Item
+            {
+                uint64_t Key{0};
+                uint32_t Index{0};
+            };
+
+            std::vector<Item> m_Items;
+            std::vector<Item> m_Scratch;
+            std::vector<uint32_t> m_Order;
+    };
+}
@@ -1,5 +1,20 @@
 #include "GL_Renderer.hpp"
+#include "GL_StateCache.hpp"
+#include "GL_QuadKernel.hpp"
+#include "GL_TextureArray.hpp"
+#include "GL_RenderQueue.hpp"
+#include "GL_TextRenderer.hpp"
 #include "Assert.hpp"
+#include "Instrument.hpp"
+
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstring>
+#include <numeric>
+#include <glm/gtc/packing.hpp>
 
 namespace DviCore 
 {
@@ -7,9 +22,22 @@ namespace DviCore
     static const uint32_t MAX_VERTICES              = MAX_QUADS * 4;
     static const uint32_t MAX_INDICES               = MAX_QUADS * 6;
     static const uint32_t MAX_TEXTURE_SLOTS         = 32;
+    static const uint32_t MAX_BINDLESS_TEXTURES     = 4096;
+    static const uint32_t BINDLESS_HANDLE_BINDING   = 1;
+    static const uint32_t ARRAY_LAYER_BITS          = 8;
     static const uint32_t MAX_QUAD_VERTEX_COUNT     = 4;
+    static const uint32_t MAX_STREAMING_REGIONS     = 8;
+    static const uint32_t MAX_LINES                 = 32768;
+    static const uint32_t MAX_LINE_VERTICES         = MAX_LINES * 2;
+    static const uint32_t LINE_MODE_COUNT           = 2;
+    static const uint32_t MAX_POINTS                = 65536;
+    static const uint32_t PIPELINE_COUNT            = 3;
+    static const uint64_t FENCE_WAIT_TIMEOUT        = 1000000;
     static const glm::vec4 DEFAULT_COLOR            = { 1.0f, 1.0f, 1.0f, 1.0f };
     static const glm::vec2 DEFAULT_TEX_COORDS[]     = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+    static const glm::vec4 NO_SHAPE                 = { 0.0f, 0.0f, 0.0f, 1.0f };
+    static const glm::vec4 GLYPH_SHAPE              = { -1.0f, 0.0f, 0.0f, 1.0f };
+    static const uint16_t PACKED_UNIT_TILING        = glm::packHalf1x16(1.0f);
 
     struct Vertex 
     {
@@ -18,155 +46,1258 @@ namespace DviCore
 		glm::vec2 TexCoords;
 		float TexIndex;
 		float TilingFactor;
+		glm::vec4 Shape;
 	};
 
+    struct QuadInstance 
+    {
+        glm::vec3 AxisX;
+        glm::vec3 AxisY;
+        glm::vec3 Translation;
+        uint32_t Color;
+        glm::vec4 TexRect;
+        float TexIndex;
+        float TilingFactor;
+        glm::vec4 Shape;
+    };
+
+    struct CompactVertex 
+    {
+        glm::vec3 Position;
+        uint32_t Color;
+        uint32_t TexCoords;
+        uint16_t TexIndex;
+        uint16_t TilingFactor;
+        uint64_t Shape;
+    };
+
+    struct LineVertex 
+    {
+        glm::vec3 Position;
+        glm::vec4 Color;
+    };
+
+    // One vertex per point sprite, 20 bytes against the 128 of a compact quad's four vertices, and no indices.
+    struct PointVertex 
+    {
+        glm::vec3 Position;
+        uint32_t Color;
+        float Size;
+    };
+
+    // Consecutive points sharing a texture, each run is one draw.
+    struct PointRun 
+    {
+        std::shared_ptr<Texture> TexturePtr;
+        uint32_t Count;
+    };
+
+    struct DrawElementsIndirectCommand 
+    {
+        uint32_t Count;
+        uint32_t InstanceCount;
+        uint32_t FirstIndex;
+        int32_t BaseVertex;
+        uint32_t BaseInstance;
+    };
+
+    struct QueuedQuad 
+    {
+        QuadAffine Quad;
+        glm::vec4 Color;
+        glm::vec2 TexCoords[MAX_QUAD_VERTEX_COUNT];
+        uint32_t TextureId;
+        float TilingFactor;
+        glm::vec4 Shape;
+        bool Translucent;
+    };
+
+    static_assert(sizeof(QuadInstance) % 4 == 0, "Quad instances must stay 4-byte aligned!");
+    static_assert(sizeof(CompactVertex) % 4 == 0, "Compact vertices must stay 4-byte aligned!");
+    static_assert(MAX_VERTICES <= UINT16_MAX + 1, "Batches must fit 16-bit indices!");
+    static_assert(TextureArray::MAX_LAYERS <= (1 << ARRAY_LAYER_BITS), "Array layers must fit their bits of the texture index!");
+    static_assert((MAX_TEXTURE_SLOTS << ARRAY_LAYER_BITS) <= UINT16_MAX + 1, "Array texture indices must fit compact vertices!");
+    static_assert(MAX_BINDLESS_TEXTURES <= UINT16_MAX + 1, "Bindless texture indices must fit compact vertices!");
+
+    // Regions are addressed by base vertex or base instance, so every format's stride has to divide them exactly.
+    static const GLsizeiptr REGION_STRIDE           = std::lcm(std::lcm(sizeof(Vertex), sizeof(QuadInstance)), sizeof(CompactVertex));
+    static const GLsizeiptr REGION_SIZE             = (MAX_VERTICES * sizeof(Vertex) + REGION_STRIDE - 1) / REGION_STRIDE * REGION_STRIDE;
+    static const uint32_t REGION_VERTICES           = REGION_SIZE / sizeof(Vertex);
+    static const uint32_t REGION_INSTANCES          = REGION_SIZE / sizeof(QuadInstance);
+    static const uint32_t REGION_COMPACT_VERTICES   = REGION_SIZE / sizeof(CompactVertex);
+    static_assert(REGION_SIZE % sizeof(Vertex) == 0 && REGION_SIZE % sizeof(CompactVertex) == 0 && REGION_SIZE % sizeof(QuadInstance) == 0, 
+        "Streaming regions must hold a whole number of every vertex format!");
+    static const GLsizeiptr LINE_BUFFER_SIZE        = MAX_LINE_VERTICES * sizeof(LineVertex);
+    static const GLsizeiptr POINT_BUFFER_SIZE       = MAX_POINTS * sizeof(PointVertex);
+
     struct BatchData 
     {
         uint32_t QuadVAO{0};
         uint32_t QuadVBO{0};
         uint32_t QuadIBO{0};
+        uint32_t CompactVAO{0};
+        uint32_t InstanceVAO{0};
+        GLenum IndexType{ GL_UNSIGNED_INT };
 
         std::shared_ptr<Texture> PlainTexture{ nullptr };
         uint32_t PlainTextureSlot{ 0 };
         uint32_t IndexCount{ 0 };
 
-        Vertex* QuadBuffer{ nullptr };
-        Vertex* QuadBufferPtr{ nullptr };
-
-        std::shared_ptr<Shader> BatchShader{ nullptr };
+        uint8_t* RegionBuffer{ nullptr };
+        uint8_t* BufferPtr{ nullptr };
+
+        BatchRenderMode Mode{ BatchRenderMode::Vertices };
+        BatchVertexLayout Layout{ BatchVertexLayout::Standard };
+        bool Streaming{ false };
+        uint8_t* MappedBuffer{ nullptr };
+        uint32_t RegionCount{ 1 };
+        uint32_t RegionIndex{ 0 };
+        std::array<GLsync, MAX_STREAMING_REGIONS> RegionFences{};
+
+        BatchSubmission Submission{ BatchSubmission::Direct };
+        uint32_t IndirectBuffer{ 0 };
+        std::vector<DrawElementsIndirectCommand> IndirectCommands;
+        std::vector<uint32_t> PendingRegions;
+
+        std::array<std::shared_ptr<Shader>, PIPELINE_COUNT> BatchShaders;
+        std::array<std::shared_ptr<Shader>, PIPELINE_COUNT> CompactShaders;
+        std::array<std::shared_ptr<Shader>, PIPELINE_COUNT> InstanceShaders;
+        std::array<std::shared_ptr<Shader>, PIPELINE_COUNT> EdgeShaders;
         std::array<std::shared_ptr<Texture>, MAX_TEXTURE_SLOTS> TextureSlots;
         uint32_t TextureSlotIndex{ 1 };
+        bool PlainUsed{ false };
+        bool TexturedUsed{ false };
+
+        BatchTextureBackend TextureBackend{ BatchTextureBackend::Slots };
+        TextureArrayCache TextureArrays;
+        std::array<uint32_t, MAX_TEXTURE_SLOTS> ArraySlots{};
+        uint32_t HandleBuffer{ 0 };
+        std::vector<std::shared_ptr<Texture>> BindlessTextures;
+        std::vector<uint64_t> BindlessHandles;
+        std::unordered_map<const Texture*, uint32_t> BindlessLookup;
+
+        bool Culling{ false };
+        bool EdgeAntialiasing{ false };
+        std::array<glm::vec4, 6> FrustumPlanes{};
+        std::vector<QuadAffine> CullAffines;
+        std::vector<uint32_t> CullIndices;
+
+        bool Queued{ false };
+        uint8_t SortLayer{ 0 };
+        glm::mat4 ViewProjection{ 1.0f };
+        RenderQueue Queue;
+        std::vector<QueuedQuad> QueuedQuads;
+        std::vector<std::shared_ptr<Texture>> QueueTextures{ nullptr };
+        std::unordered_map<const Texture*, uint32_t> QueueTextureIds;
+
+        std::vector<QuadAffine> BulkAffines;
+        std::vector<glm::vec3> BulkCorners;
+        std::vector<float> BulkSlots;
+
+        uint32_t LineVAO{0};
+        uint32_t LineVBO{0};
+        std::shared_ptr<Shader> LineShader{ nullptr };
+        std::array<std::vector<LineVertex>, LINE_MODE_COUNT> LineVertices;
+
+        uint32_t PointVAO{0};
+        uint32_t PointVBO{0};
+        std::shared_ptr<Shader> PointShader{ nullptr };
+        std::vector<PointVertex> PointVertices;
+        std::vector<PointRun> PointRuns;
 
         BatchRenderer::RendererStatus Status;
-        glm::vec4 QuadVertexPositions[MAX_QUAD_VERTEX_COUNT];
 
     }; static BatchData s_BatchData;
 
+    static void IssueIndirect();
+
+    // Streaming mode: the vertex buffer is a ring of batch-sized regions, each guarded by the fence of its last draw.
+    static void AcquireRegion() 
+    {
+        // Indirect regions are only drawn once their commands are issued, a region can't be reused before that.
+        if(s_BatchData.PendingRegions.size() == s_BatchData.RegionCount)
+            IssueIndirect();
+
+        if(s_BatchData.Streaming) 
+        {
+            GLsync& fence = s_BatchData.RegionFences[s_BatchData.RegionIndex];
+            if(fence != nullptr) 
+            {
+                GLenum result = glClientWaitSync(fence, 0, 0);
+                if(result == GL_TIMEOUT_EXPIRED) 
+                {
+                    auto start = std::chrono::high_resolution_clock::now();
+                    while(result == GL_TIMEOUT_EXPIRED)
+                        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_WAIT_TIMEOUT);
+
+                    std::chrono::duration<float, std::milli> waited = std::chrono::high_resolution_clock::now() - start;
+                    s_BatchData.Status.FenceWaitTime += waited.count();
+                    s_BatchData.Status.FenceWaitCount++;
+                }
+
+                DVIMANA_ASSERT(result != GL_WAIT_FAILED, "Failed to wait for batch region fence!");
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+
+            s_BatchData.RegionBuffer = s_BatchData.MappedBuffer + (s_BatchData.RegionIndex * REGION_SIZE);
+        }
+
+        s_BatchData.BufferPtr = s_BatchData.RegionBuffer;
+    }
+
+    static void ReleaseRegion() 
+    {
+        if(!s_BatchData.Streaming)
+            return;
+
+        s_BatchData.RegionFences[s_BatchData.RegionIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        s_BatchData.RegionIndex = (s_BatchData.RegionIndex + 1) % s_BatchData.RegionCount;
+    }
+
+    static GLsizeiptr RegionBytesWritten() 
+    {
+        return s_BatchData.BufferPtr - s_BatchData.RegionBuffer;
+    }
+
+    // Extracts the clip planes straight from the view projection (Gribb/Hartmann), works for orthographic and perspective
+    // cameras alike.
+    static void ExtractFrustum(const glm::mat4& mvp) 
+    {
+        glm::vec4 rows[4];
+        for(int32_t i = 0; i < 4; i++)
+            rows[i] = { mvp[0][i], mvp[1][i], mvp[2][i], mvp[3][i] };
+
+        for(int32_t i = 0; i < 3; i++) 
+        {
+            s_BatchData.FrustumPlanes[i * 2 + 0] = rows[3] + rows[i];
+            s_BatchData.FrustumPlanes[i * 2 + 1] = rows[3] - rows[i];
+        }
+
+        for(glm::vec4& plane : s_BatchData.FrustumPlanes) 
+        {
+            float length = glm::length(glm::vec3(plane));
+            if(length > 0.0f)
+                plane /= length;
+        }
+    }
+
+    // Tests the quad's bounding circle, conservative for any rotation so only quads fully outside a plane are rejected.
+    static bool InFrustum(const QuadAffine& quad, const std::array<glm::vec4, 6>& planes) 
+    {
+        float radius = 0.5f * (glm::length(quad.AxisX) + glm::length(quad.AxisY));
+        for(const glm::vec4& plane : planes) 
+        {
+            if(glm::dot(glm::vec3(plane), quad.Translation) + plane.w < -radius)
+                return false;
+        }
+
+        return true;
+    }
+
+    // The camera reaches the shaders through the shared frame constants, samplers are bound to their units by layout
+    // qualifiers, so starting a batch is one buffer update. The program is picked when the batch is drawn.
+    static void StartBatch(const glm::mat4& view, const glm::mat4& projection) 
+    {
+        Renderer::UpdateFrameConstants(view, projection);
+        s_BatchData.ViewProjection = Renderer::GetFrameConstants().ViewProjection;
+        ExtractFrustum(s_BatchData.ViewProjection);
+
+        AcquireRegion();
+    }
+
+    static void ResetTextureTable() 
+    {
+        s_BatchData.TextureSlotIndex = 1;
+        s_BatchData.PlainUsed = false;
+        s_BatchData.TexturedUsed = false;
+        if(s_BatchData.TextureBackend == BatchTextureBackend::Bindless) 
+        {
+            s_BatchData.BindlessTextures.resize(1);
+            s_BatchData.BindlessHandles.resize(1);
+            s_BatchData.BindlessLookup.clear();
+        }
+    }
+
+    static void BindTextureTable() 
+    {
+        switch(s_BatchData.TextureBackend) 
+        {
+            case BatchTextureBackend::Bindless:
+                glNamedBufferSubData(s_BatchData.HandleBuffer, 0, s_BatchData.BindlessHandles.size() * sizeof(uint64_t), s_BatchData.BindlessHandles.data());
+                GLStateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDLESS_HANDLE_BINDING, s_BatchData.HandleBuffer);
+                break;
+
+            case BatchTextureBackend::Arrays:
+                for(uint32_t i = 0; i < s_BatchData.TextureSlotIndex; i++)
+                    GLStateCache::BindTextureUnit(i, s_BatchData.TextureArrays.ArrayID(s_BatchData.ArraySlots[i]));
+                break;
+
+            default:
+                for(uint32_t i = 0; i < s_BatchData.TextureSlotIndex; i++)
+                    s_BatchData.TextureSlots[i]->Bind(i);
+                break;
+        }
+    }
+
+    // A batch that never resolved a real texture draws color-only, one whose quads all read the same sampler draws with that
+    // sampler fixed, everything else indexes the sampler table per fragment. Sampler 0 always holds the plain texture, or its
+    // texture array, so the fixed sampler is 1 for every backend.
+    static BatchPipeline SelectPipeline() 
+    {
+        if(!s_BatchData.TexturedUsed)
+            return BatchPipeline::ColorOnly;
+
+        bool single = false;
+        switch(s_BatchData.TextureBackend) 
+        {
+            case BatchTextureBackend::Bindless: single = !s_BatchData.PlainUsed && s_BatchData.BindlessTextures.size() == 2; break;
+            default:                            single = !s_BatchData.PlainUsed && s_BatchData.TextureSlotIndex == 2; break;
+        }
+
+        return single ? BatchPipeline::SingleTexture : BatchPipeline::MultiTexture;
+    }
+
+    // Binds the program of the batch's pipeline and whatever textures that pipeline samples.
+    static void BindBatchPipeline() 
+    {
+        BatchPipeline pipeline = SelectPipeline();
+        std::array<std::shared_ptr<Shader>, PIPELINE_COUNT>* shaders = &s_BatchData.BatchShaders;
+        if(s_BatchData.Mode == BatchRenderMode::Instanced)
+            shaders = s_BatchData.EdgeAntialiasing ? &s_BatchData.EdgeShaders : &s_BatchData.InstanceShaders;
+        else if(s_BatchData.Layout == BatchVertexLayout::Compact)
+            shaders = &s_BatchData.CompactShaders;
+
+        // The blended rims of anti-aliased quads can't write depth in submission order, a rim drawn first would hide the
+        // quads behind it. End() turns depth writes back on.
+        if(shaders == &s_BatchData.EdgeShaders)
+            GLStateCache::DepthMask(false);
+
+        (*shaders)[static_cast<uint32_t>(pipeline)]->Bind();
+        if(pipeline == BatchPipeline::ColorOnly)
+            s_BatchData.Status.ColorOnlyDrawCount++;
+        else
+            BindTextureTable();
+
+        if(pipeline == BatchPipeline::SingleTexture)
+            s_BatchData.Status.SingleTextureDrawCount++;
+    }
+
+    static bool TextureTableFull() 
+    {
+        if(s_BatchData.TextureBackend == BatchTextureBackend::Bindless)
+            return s_BatchData.BindlessTextures.size() >= MAX_BINDLESS_TEXTURES;
+
+        return s_BatchData.TextureSlotIndex >= MAX_TEXTURE_SLOTS;
+    }
+
+    static DrawElementsIndirectCommand RegionCommand() 
+    {
+        DrawElementsIndirectCommand command{ s_BatchData.IndexCount, 1, 0, 0, 0 };
+        if(s_BatchData.Mode == BatchRenderMode::Instanced) 
+        {
+            command.Count = 6;
+            command.InstanceCount = s_BatchData.IndexCount / 6;
+            command.BaseInstance = s_BatchData.RegionIndex * REGION_INSTANCES;
+        }
+        else if(s_BatchData.Layout == BatchVertexLayout::Compact) 
+        {
+            command.BaseVertex = s_BatchData.RegionIndex * REGION_COMPACT_VERTICES;
+        }
+        else 
+        {
+            command.BaseVertex = s_BatchData.RegionIndex * REGION_VERTICES;
+        }
+
+        return command;
+    }
+
+    static void BindBatchVertexArray() 
+    {
+        if(s_BatchData.Mode == BatchRenderMode::Instanced)
+            GLStateCache::BindVertexArray(s_BatchData.InstanceVAO);
+        else if(s_BatchData.Layout == BatchVertexLayout::Compact)
+            GLStateCache::BindVertexArray(s_BatchData.CompactVAO);
+        else
+            GLStateCache::BindVertexArray(s_BatchData.QuadVAO);
+    }
+
+    // Indirect submission: every pending region shares one texture table, so all of them go out in a single multi-draw.
+    static void IssueIndirect() 
+    {
+        if(s_BatchData.PendingRegions.empty())
+            return;
+
+        if(!s_BatchData.IndirectCommands.empty()) 
+        {
+            BindBatchPipeline();
+            BindBatchVertexArray();
+
+            GLsizei count = static_cast<GLsizei>(s_BatchData.IndirectCommands.size());
+            glNamedBufferSubData(s_BatchData.IndirectBuffer, 0, count * sizeof(DrawElementsIndirectCommand), s_BatchData.IndirectCommands.data());
+            GLStateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, s_BatchData.IndirectBuffer);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, s_BatchData.IndexType, nullptr, count, 0);
+            s_BatchData.Status.DrawCount++;
+        }
+
+        if(s_BatchData.Streaming) 
+        {
+            for(uint32_t region : s_BatchData.PendingRegions)
+                s_BatchData.RegionFences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+
+        s_BatchData.IndirectCommands.clear();
+        s_BatchData.PendingRegions.clear();
+        ResetTextureTable();
+    }
+
+    static void SubmitRegion() 
+    {
+        GLsizeiptr size = RegionBytesWritten();
+        if(!s_BatchData.Streaming) 
+        {
+            GLStateCache::BindBuffer(GL_ARRAY_BUFFER, s_BatchData.QuadVBO);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, size, s_BatchData.RegionBuffer);
+        }
+
+        s_BatchData.Status.UploadBytes += size;
+
+        if(s_BatchData.Submission == BatchSubmission::Direct) 
+        {
+            BatchRenderer::Flush();
+            ReleaseRegion();
+            return;
+        }
+
+        if(s_BatchData.IndexCount > 0) 
+        {
+            s_BatchData.IndirectCommands.push_back(RegionCommand());
+            s_BatchData.Status.IndirectCommandCount++;
+        }
+
+        s_BatchData.PendingRegions.push_back(s_BatchData.RegionIndex);
+        s_BatchData.RegionIndex = (s_BatchData.RegionIndex + 1) % s_BatchData.RegionCount;
+        s_BatchData.IndexCount = 0;
+
+        if(TextureTableFull())
+            IssueIndirect();
+    }
 
     void BatchRenderer::Restart() 
     {
-        End();
-        s_BatchData.QuadBufferPtr = s_BatchData.QuadBuffer;
+        SubmitRegion();
+        AcquireRegion();
         s_BatchData.IndexCount = 0;
-        s_BatchData.TextureSlotIndex = 1;
     }
 
-    void BatchRenderer::Init() 
+    static size_t QuadBytes(BatchRenderMode mode, BatchVertexLayout layout) 
+    {
+        if(mode == BatchRenderMode::Instanced)
+            return sizeof(QuadInstance);
+        if(layout == BatchVertexLayout::Compact)
+            return sizeof(CompactVertex) * MAX_QUAD_VERTEX_COUNT;
+        return sizeof(Vertex) * MAX_QUAD_VERTEX_COUNT;
+    }
+
+    // Writes one quad in the given format. Corners may be null when the caller hasn't run the corner kernel itself.
+    // Untextured quads are written by the Textured = false instantiation, which stores constants for the texture index and
+    // tiling. Texture coordinates are kept, shapes measure their coverage with them. The fields are still written, a batch
+    // may draw with a textured pipeline after all and the mapped buffer is write-combined, skipping bytes would only break up
+    // its line writes.
+    template<bool Textured>
+    static void WriteQuadData(uint8_t* destination, BatchRenderMode mode, BatchVertexLayout layout, const QuadAffine& quad, const glm::vec3* corners, 
+        const glm::vec4& color, const glm::vec2* tex_coords, float texture_index, float tiling_factor, const glm::vec4& shape = NO_SHAPE) 
+    {
+        if(mode == BatchRenderMode::Instanced) 
+        {
+            QuadInstance* instance  = reinterpret_cast<QuadInstance*>(destination);
+            instance->AxisX         = quad.AxisX;
+            instance->AxisY         = quad.AxisY;
+            instance->Translation   = quad.Translation;
+            instance->Color         = glm::packUnorm4x8(color);
+            instance->TexRect       = { tex_coords[0].x, tex_coords[0].y, tex_coords[2].x, tex_coords[2].y };
+            instance->TexIndex      = Textured ? texture_index : 0.0f;
+            instance->TilingFactor  = Textured ? tiling_factor : 1.0f;
+            instance->Shape         = shape;
+            return;
+        }
+
+        glm::vec3 quad_corners[MAX_QUAD_VERTEX_COUNT];
+        if(corners == nullptr) 
+        {
+            QuadKernel::Corners(&quad, 1, quad_corners);
+            corners = quad_corners;
+        }
+
+        if(layout == BatchVertexLayout::Compact) 
+        {
+            CompactVertex* vertex = reinterpret_cast<CompactVertex*>(destination);
+            uint32_t packed_color = glm::packUnorm4x8(color);
+            uint16_t packed_index = Textured ? static_cast<uint16_t>(texture_index) : 0;
+            uint16_t packed_tiling = Textured ? glm::packHalf1x16(tiling_factor) : PACKED_UNIT_TILING;
+            uint64_t packed_shape = glm::packHalf4x16(shape);
+
+            for(uint32_t i = 0; i < MAX_QUAD_VERTEX_COUNT; i++, vertex++) 
+            {
+                vertex->Position        = corners[i];
+                vertex->Color           = packed_color;
+                vertex->TexCoords       = glm::packUnorm2x16(tex_coords[i]);
+                vertex->TexIndex        = packed_index;
+                vertex->TilingFactor    = packed_tiling;
+                vertex->Shape           = packed_shape;
+            }
+        }
+        else 
+        {
+            Vertex* vertex = reinterpret_cast<Vertex*>(destination);
+            for(uint32_t i = 0; i < MAX_QUAD_VERTEX_COUNT; i++, vertex++) 
+            {
+                vertex->Position        = corners[i];
+                vertex->Color           = color;
+                vertex->TexCoords       = tex_coords[i];
+                vertex->TexIndex        = Textured ? texture_index : 0.0f;
+                vertex->TilingFactor    = Textured ? tiling_factor : 1.0f;
+                vertex->Shape           = shape;
+            }
+        }
+    }
+
+    // Rewrites the texture indices of already written quads, used when recorded quads land in different texture slots.
+    static void RemapTextureIndices(uint8_t* data, size_t quad_count, BatchRenderMode mode, BatchVertexLayout layout, const float* remap) 
+    {
+        if(mode == BatchRenderMode::Instanced) 
+        {
+            QuadInstance* instance = reinterpret_cast<QuadInstance*>(data);
+            for(size_t i = 0; i < quad_count; i++, instance++)
+                instance->TexIndex = remap[static_cast<uint32_t>(instance->TexIndex)];
+        }
+        else if(layout == BatchVertexLayout::Compact) 
+        {
+            CompactVertex* vertex = reinterpret_cast<CompactVertex*>(data);
+            for(size_t i = 0; i < quad_count * MAX_QUAD_VERTEX_COUNT; i++, vertex++)
+                vertex->TexIndex = static_cast<uint16_t>(remap[vertex->TexIndex]);
+        }
+        else 
+        {
+            Vertex* vertex = reinterpret_cast<Vertex*>(data);
+            for(size_t i = 0; i < quad_count * MAX_QUAD_VERTEX_COUNT; i++, vertex++)
+                vertex->TexIndex = remap[static_cast<uint32_t>(vertex->TexIndex)];
+        }
+    }
+
+    template<bool Textured>
+    static void WriteQuad(const QuadAffine& quad, const glm::vec4& color, const glm::vec2* tex_coords, float texture_index, float tiling_factor, const glm::vec4& shape) 
+    {
+        WriteQuadData<Textured>(s_BatchData.BufferPtr, s_BatchData.Mode, s_BatchData.Layout, quad, nullptr, color, tex_coords, texture_index, tiling_factor, shape);
+        s_BatchData.BufferPtr += QuadBytes(s_BatchData.Mode, s_BatchData.Layout);
+        s_BatchData.IndexCount += 6;
+        s_BatchData.Status.QuadCount++;
+    }
+
+    // Finds the slot of a texture in a slot table or appends it, slot 0 always holds the plain texture.
+    static bool FindTextureSlot(std::shared_ptr<Texture>* slots, uint32_t& slot_count, const std::shared_ptr<Texture>& texture, uint32_t& slot) 
+    {
+        slot = 1;
+        while(slot < slot_count && slots[slot] != texture)
+            slot++;
+
+        if(slot < slot_count)
+            return true;
+        if(slot_count >= MAX_TEXTURE_SLOTS)
+            return false;
+
+        slots[slot_count++] = texture;
+        return true;
+    }
+
+    // Returns the index a quad stores for its texture, false when the batch has no room left for another texture. Slots index
+    // the bound textures, arrays pack the bound array in the high bits and the layer in the low ones, bindless indexes the
+    // batch's handle buffer.
+    static bool ResolveTexture(const std::shared_ptr<Texture>& texture, float& texture_index) 
+    {
+        if(texture == nullptr || texture == s_BatchData.PlainTexture) 
+        {
+            s_BatchData.PlainUsed = true;
+            texture_index = 0.0f;
+            return true;
+        }
+
+        s_BatchData.TexturedUsed = true;
+        switch(s_BatchData.TextureBackend) 
+        {
+            case BatchTextureBackend::Bindless: 
+            {
+                auto found = s_BatchData.BindlessLookup.find(texture.get());
+                if(found != s_BatchData.BindlessLookup.end()) 
+                {
+                    texture_index = static_cast<float>(found->second);
+                    return true;
+                }
+
+                uint32_t index = static_cast<uint32_t>(s_BatchData.BindlessTextures.size());
+                if(index >= MAX_BINDLESS_TEXTURES)
+                    return false;
+
+                s_BatchData.BindlessTextures.push_back(texture);
+                s_BatchData.BindlessHandles.push_back(texture->BindlessHandle());
+                s_BatchData.BindlessLookup[texture.get()] = index;
+                texture_index = static_cast<float>(index);
+                return true;
+            }
+
+            case BatchTextureBackend::Arrays: 
+            {
+                TextureLayer location = s_BatchData.TextureArrays.Locate(texture);
+                uint32_t slot = 0;
+                while(slot < s_BatchData.TextureSlotIndex && s_BatchData.ArraySlots[slot] != location.Array)
+                    slot++;
+
+                if(slot == s_BatchData.TextureSlotIndex) 
+                {
+                    if(slot >= MAX_TEXTURE_SLOTS)
+                        return false;
+
+                    s_BatchData.ArraySlots[s_BatchData.TextureSlotIndex++] = location.Array;
+                }
+
+                texture_index = static_cast<float>((slot << ARRAY_LAYER_BITS) | location.Layer);
+                return true;
+            }
+
+            default: 
+            {
+                uint32_t slot = 0;
+                if(!FindTextureSlot(s_BatchData.TextureSlots.data(), s_BatchData.TextureSlotIndex, texture, slot))
+                    return false;
+
+                texture_index = static_cast<float>(slot);
+                return true;
+            }
+        }
+    }
+
+    static uint32_t QueueTextureId(const std::shared_ptr<Texture>& texture) 
+    {
+        if(texture == nullptr || texture == s_BatchData.PlainTexture)
+            return 0;
+
+        auto [found, inserted] = s_BatchData.QueueTextureIds.try_emplace(texture.get(), static_cast<uint32_t>(s_BatchData.QueueTextures.size()));
+        if(inserted)
+            s_BatchData.QueueTextures.push_back(texture);
+
+        return found->second;
+    }
+
+    static bool EdgeAntialiased() 
+    {
+        return s_BatchData.EdgeAntialiasing && s_BatchData.Mode == BatchRenderMode::Instanced;
+    }
+
+    static void QueueQuad(const QuadAffine& quad, const glm::vec4& color, const glm::vec2* tex_coords, const std::shared_ptr<Texture>& texture, float tiling_factor, 
+        const glm::vec4& shape = NO_SHAPE) 
+    {
+        // Shapes, glyphs and anti-aliased quads cut their coverage out of the quad, their edges always blend.
+        uint32_t texture_id = QueueTextureId(texture);
+        bool translucent = color.a < 1.0f || shape.x != 0.0f || (texture_id != 0 && !texture->Opaque()) || EdgeAntialiased();
+        glm::vec4 clip = s_BatchData.ViewProjection * glm::vec4(quad.Translation, 1.0f);
+        float depth = clip.w != 0.0f ? clip.z / clip.w : clip.z;
+        s_BatchData.Queue.Push(RenderQueue::Key(s_BatchData.SortLayer, translucent, 0, static_cast<uint16_t>(texture_id), depth));
+
+        QueuedQuad& queued = s_BatchData.QueuedQuads.emplace_back();
+        queued.Quad = quad;
+        queued.Color = color;
+        std::copy(tex_coords, tex_coords + MAX_QUAD_VERTEX_COUNT, queued.TexCoords);
+        queued.TextureId = texture_id;
+        queued.TilingFactor = tiling_factor;
+        queued.Shape = shape;
+        queued.Translucent = translucent;
+    }
+
+    // Counts the batches a queue order needs under the active backend's texture limits, so sorted and submission order
+    // can be compared. The sorted order also breaks where the opaque pass hands over to the translucent one.
+    static uint32_t CountBatches(const uint32_t* order, const std::vector<uint32_t>& bindings, uint32_t capacity) 
+    {
+        std::vector<uint32_t> stamps(bindings.empty() ? 1 : *std::max_element(bindings.begin(), bindings.end()) + 1, 0);
+        uint32_t batches = 1, quads = 0, bound = 0;
+        bool translucent = false;
+
+        for(size_t i = 0; i < s_BatchData.QueuedQuads.size(); i++) 
+        {
+            const QueuedQuad& queued = s_BatchData.QueuedQuads[order ? order[i] : i];
+            uint32_t binding = bindings[queued.TextureId];
+            bool new_binding = binding != 0 && stamps[binding] != batches;
+            bool new_pass = order && quads > 0 && queued.Translucent != translucent;
+            translucent = queued.Translucent;
+            if(quads == MAX_QUADS || new_pass || (new_binding && bound == capacity)) 
+            {
+                batches++;
+                quads = 0;
+                bound = 0;
+                new_binding = binding != 0;
+            }
+
+            if(new_binding) 
+            {
+                stamps[binding] = batches;
+                bound++;
+            }
+
+            quads++;
+        }
+
+        return batches;
+    }
+
+    static void SetPassState(bool translucent) 
+    {
+        if(translucent) 
+        {
+            GLStateCache::Enable(GL_BLEND);
+            GLStateCache::DepthMask(false);
+        }
+        else 
+        {
+            GLStateCache::Disable(GL_BLEND);
+            GLStateCache::DepthMask(true);
+        }
+    }
+
+    template<typename T>
+    static const T& StreamAt(const uint8_t* stream, size_t stride, size_t index) 
+    {
+        return *reinterpret_cast<const T*>(stream + stride * index);
+    }
+
+    // Resolves the texture slots of a whole chunk in one pass, runs of the same texture skip the slot search. Returns how
+    // many quads of the chunk fit before the texture slots run out.
+    static size_t ResolveTextureSlots(const uint8_t* textures, size_t stride, const uint32_t* indices, size_t first, size_t count) 
+    {
+        float* slots = s_BatchData.BulkSlots.data();
+        if(textures == nullptr) 
+        {
+            s_BatchData.PlainUsed = true;
+            std::fill(slots, slots + count, 0.0f);
+            return count;
+        }
+
+        const Texture* last_texture = nullptr;
+        float last_slot = 0.0f;
+        for(size_t i = 0; i < count; i++) 
+        {
+            size_t index = indices ? indices[first + i] : first + i;
+            const std::shared_ptr<Texture>& texture = StreamAt<std::shared_ptr<Texture>>(textures, stride, index);
+            if(texture.get() != last_texture) 
+            {
+                if(!ResolveTexture(texture, last_slot))
+                    return i;
+
+                last_texture = texture.get();
+            }
+
+            slots[i] = last_slot;
+        }
+
+        return count;
+    }
+
+    // Lines stay on the CPU until the batch ends, so they can be submitted from anywhere in the frame. Depth-tested lines
+    // go out before overlay lines, each mode in as few draws as the line buffer holds.
+    static void FlushLines() 
+    {
+        if(s_BatchData.LineVertices[0].empty() && s_BatchData.LineVertices[1].empty())
+            return;
+
+        DVI_PROFILE_SCOPE("BatchRenderer::FlushLines");
+        s_BatchData.LineShader->Bind();
+        GLStateCache::BindVertexArray(s_BatchData.LineVAO);
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, s_BatchData.LineVBO);
+
+        for(uint32_t mode = 0; mode < LINE_MODE_COUNT; mode++) 
+        {
+            std::vector<LineVertex>& vertices = s_BatchData.LineVertices[mode];
+            if(vertices.empty())
+                continue;
+
+            bool overlay = static_cast<BatchLineMode>(mode) == BatchLineMode::Overlay;
+            if(overlay)
+                GLStateCache::Disable(GL_DEPTH_TEST);
+
+            for(size_t first = 0; first < vertices.size(); first += MAX_LINE_VERTICES) 
+            {
+                GLsizei count = static_cast<GLsizei>(std::min<size_t>(MAX_LINE_VERTICES, vertices.size() - first));
+                GLsizeiptr size = count * sizeof(LineVertex);
+
+                // Orphaning hands every chunk a fresh allocation, so an upload never waits on the previous chunk's draw.
+                glBufferData(GL_ARRAY_BUFFER, LINE_BUFFER_SIZE, nullptr, GL_STREAM_DRAW);
+                glBufferSubData(GL_ARRAY_BUFFER, 0, size, vertices.data() + first);
+                glDrawArrays(GL_LINES, 0, count);
+
+                s_BatchData.Status.UploadBytes += size;
+                s_BatchData.Status.DrawCount++;
+                s_BatchData.Status.LineDrawCount++;
+            }
+
+            if(overlay)
+                GLStateCache::Enable(GL_DEPTH_TEST);
+
+            vertices.clear();
+        }
+    }
+
+    // Points are kept until the batch ends like lines and drawn before them, one draw per texture run and buffer chunk.
+    static void FlushPoints() 
+    {
+        if(s_BatchData.PointVertices.empty())
+            return;
+
+        DVI_PROFILE_SCOPE("BatchRenderer::FlushPoints");
+        s_BatchData.PointShader->Bind();
+        GLStateCache::BindVertexArray(s_BatchData.PointVAO);
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, s_BatchData.PointVBO);
+
+        size_t first = 0;
+        for(const PointRun& run : s_BatchData.PointRuns) 
+        {
+            run.TexturePtr->Bind(0);
+            for(size_t offset = 0; offset < run.Count; offset += MAX_POINTS) 
+            {
+                GLsizei count = static_cast<GLsizei>(std::min<size_t>(MAX_POINTS, run.Count - offset));
+                GLsizeiptr size = count * sizeof(PointVertex);
+
+                glBufferData(GL_ARRAY_BUFFER, POINT_BUFFER_SIZE, nullptr, GL_STREAM_DRAW);
+                glBufferSubData(GL_ARRAY_BUFFER, 0, size, s_BatchData.PointVertices.data() + first + offset);
+                glDrawArrays(GL_POINTS, 0, count);
+
+                s_BatchData.Status.UploadBytes += size;
+                s_BatchData.Status.DrawCount++;
+            }
+
+            first += run.Count;
+        }
+
+        s_BatchData.PointVertices.clear();
+        s_BatchData.PointRuns.clear();
+    }
+
+    // Builds one program per pipeline from the same sources, the fragment shader compiles out whatever its pipeline doesn't sample.
+    // Every batch program shares one fragment shader, the texture backend picks its texture fetch through a define.
+    static std::array<std::shared_ptr<Shader>, PIPELINE_COUNT> CreateBatchShaders(const std::string& name, const std::string& vertex_shader, 
+        const std::string& extra_defines = std::string()) 
     {
-        s_BatchData.QuadBuffer = new Vertex[MAX_VERTICES];
+        static const char* pipeline_names[PIPELINE_COUNT] = { "ColorOnly", "SingleTexture", "MultiTexture" };
+
+        std::string texture_define = "#define BATCH_TEXTURES_SLOTS\n";
+        if(s_BatchData.TextureBackend == BatchTextureBackend::Arrays)
+            texture_define = "#define BATCH_TEXTURES_ARRAYS\n";
+        else if(s_BatchData.TextureBackend == BatchTextureBackend::Bindless)
+            texture_define = "#define BATCH_TEXTURES_BINDLESS\n";
+
+        std::array<std::shared_ptr<Shader>, PIPELINE_COUNT> shaders;
+        for(uint32_t i = 0; i < PIPELINE_COUNT; i++) 
+        {
+            std::string defines = texture_define + "#define BATCH_PIPELINE " + std::to_string(i) + "\n#define BATCH_SINGLE_SLOT 1\n" + extra_defines;
+            shaders[i] = std::make_shared<Shader>(name + pipeline_names[i], vertex_shader, "Shaders/BatchFragment.glsl", defines);
+        }
+
+        return shaders;
+    }
+
+    void BatchRenderer::Init(const BatchRendererSpecifications& specification) 
+    {
+        QuadKernel::SelfCheck();
+
+        s_BatchData.Mode = specification.Mode;
+        s_BatchData.Layout = specification.Layout;
+        s_BatchData.IndexType = specification.ShortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        s_BatchData.Streaming = specification.PersistentMapping && GLAD_GL_VERSION_4_4;
+        s_BatchData.RegionCount = s_BatchData.Streaming ? std::clamp(specification.StreamingRegions, 1u, MAX_STREAMING_REGIONS) : 1;
+        s_BatchData.RegionIndex = 0;
+
+        s_BatchData.Submission = specification.Submission;
+        if(s_BatchData.Submission == BatchSubmission::Indirect && !GLAD_GL_VERSION_4_3) 
+        {
+            DVI_CORE_WARN("Multi-draw indirect needs OpenGL 4.3, submitting batches directly instead");
+            s_BatchData.Submission = BatchSubmission::Direct;
+        }
+
+        s_BatchData.Culling = specification.Culling;
+        s_BatchData.EdgeAntialiasing = specification.EdgeAntialiasing;
+        s_BatchData.Queued = specification.SortQueue;
+        s_BatchData.TextureBackend = specification.Textures;
+        if(s_BatchData.TextureBackend == BatchTextureBackend::Bindless && !GLAD_GL_ARB_bindless_texture) 
+        {
+            DVI_CORE_WARN("ARB_bindless_texture isn't supported, batching textures through texture arrays instead");
+            s_BatchData.TextureBackend = BatchTextureBackend::Arrays;
+        }
+
+        if(GLAD_GL_VERSION_4_3) 
+        {
+            glCreateBuffers(1, &s_BatchData.IndirectBuffer);
+            glNamedBufferStorage(s_BatchData.IndirectBuffer, MAX_STREAMING_REGIONS * sizeof(DrawElementsIndirectCommand), nullptr, GL_DYNAMIC_STORAGE_BIT);
+        }
+
+        s_BatchData.BulkAffines.resize(MAX_QUADS);
+        s_BatchData.BulkCorners.resize(MAX_QUADS * MAX_QUAD_VERTEX_COUNT);
+        s_BatchData.BulkSlots.resize(MAX_QUADS);
 
         glCreateVertexArrays(1, &s_BatchData.QuadVAO);
-        glBindVertexArray(s_BatchData.QuadVAO);
+        GLStateCache::BindVertexArray(s_BatchData.QuadVAO);
+        {
+            glCreateBuffers(1, &s_BatchData.QuadVBO);
+            GLStateCache::BindBuffer(GL_ARRAY_BUFFER, s_BatchData.QuadVBO);
+
+            if(s_BatchData.Streaming) 
+            {
+                GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                GLsizeiptr size = s_BatchData.RegionCount * REGION_SIZE;
+                glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+                s_BatchData.MappedBuffer = static_cast<uint8_t*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+                s_BatchData.RegionBuffer = s_BatchData.MappedBuffer;
+                DVIMANA_ASSERT(s_BatchData.MappedBuffer != nullptr, "Failed to map batch vertex buffer!");
+            }
+            else 
+            {
+                s_BatchData.RegionBuffer = new uint8_t[REGION_SIZE];
+                glBufferData(GL_ARRAY_BUFFER, REGION_SIZE, nullptr, GL_DYNAMIC_DRAW);
+            }
+
+            {
+                glEnableVertexAttribArray(0);
+                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Position));
+
+                glEnableVertexAttribArray(1);
+                glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Color));
+
+                glEnableVertexAttribArray(2);
+                glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+
+                glEnableVertexAttribArray(3);
+                glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexIndex));
+
+                glEnableVertexAttribArray(4);
+                glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TilingFactor));
+
+                glEnableVertexAttribArray(5);
+                glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Shape));
+            }
+
+            int32_t indices[MAX_INDICES];
+            uint32_t offset = 0;
+            for(uint32_t i = 0; i < MAX_INDICES; i += 6){
+                indices[i + 0] = offset + 0;
+                indices[i + 1] = offset + 1;
+                indices[i + 2] = offset + 2;
+
+                indices[i + 3] = offset + 2;
+                indices[i + 4] = offset + 3;
+                indices[i + 5] = offset + 0;
+
+                offset += 4;
+            }
+
+            glCreateBuffers(1, &s_BatchData.QuadIBO);
+            GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_BatchData.QuadIBO);
+            if(s_BatchData.IndexType == GL_UNSIGNED_SHORT) 
+            {
+                std::vector<uint16_t> short_indices(indices, indices + MAX_INDICES);
+                glBufferData(GL_ELEMENT_ARRAY_BUFFER, MAX_INDICES * sizeof(uint16_t), short_indices.data(), GL_STATIC_DRAW);
+            }
+            else 
+            {
+                glBufferData(GL_ELEMENT_ARRAY_BUFFER, MAX_INDICES * sizeof(uint32_t), indices, GL_STATIC_DRAW);
+            }
+
+            for(uint32_t i = 0; i < MAX_TEXTURE_SLOTS; i++)
+                s_BatchData.TextureSlots[i] = nullptr;
+
+            s_BatchData.PlainTexture = std::make_shared<Texture>(1, 1);
+            s_BatchData.TextureSlots[0] = s_BatchData.PlainTexture;
+
+            if(s_BatchData.TextureBackend == BatchTextureBackend::Arrays)
+                s_BatchData.ArraySlots[0] = s_BatchData.TextureArrays.Locate(s_BatchData.PlainTexture).Array;
+
+            if(s_BatchData.TextureBackend == BatchTextureBackend::Bindless) 
+            {
+                s_BatchData.BindlessTextures = { s_BatchData.PlainTexture };
+                s_BatchData.BindlessHandles = { s_BatchData.PlainTexture->BindlessHandle() };
+                glCreateBuffers(1, &s_BatchData.HandleBuffer);
+                glNamedBufferStorage(s_BatchData.HandleBuffer, MAX_BINDLESS_TEXTURES * sizeof(uint64_t), nullptr, GL_DYNAMIC_STORAGE_BIT);
+            }
+
+            s_BatchData.BatchShaders = CreateBatchShaders("BatchShader", "Shaders/BatchVertex.glsl");
+        }
+
+        glCreateVertexArrays(1, &s_BatchData.CompactVAO);
+        GLStateCache::BindVertexArray(s_BatchData.CompactVAO);
+        {
+            GLStateCache::BindBuffer(GL_ARRAY_BUFFER, s_BatchData.QuadVBO);
+            GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_BatchData.QuadIBO);
+
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, Position));
+
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, Color));
+
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, TexCoords));
+
+            glEnableVertexAttribArray(3);
+            glVertexAttribIPointer(3, 1, GL_UNSIGNED_SHORT, sizeof(CompactVertex), (void*)offsetof(CompactVertex, TexIndex));
+
+            glEnableVertexAttribArray(4);
+            glVertexAttribPointer(4, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, TilingFactor));
+
+            glEnableVertexAttribArray(5);
+            glVertexAttribPointer(5, 4, GL_HALF_FLOAT, GL_FALSE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, Shape));
+
+            s_BatchData.CompactShaders = CreateBatchShaders("BatchCompactShader", "Shaders/BatchCompactVertex.glsl");
+        }
+
+        glCreateVertexArrays(1, &s_BatchData.InstanceVAO);
+        GLStateCache::BindVertexArray(s_BatchData.InstanceVAO);
+        {
+            GLStateCache::BindBuffer(GL_ARRAY_BUFFER, s_BatchData.QuadVBO);
+            GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_BatchData.QuadIBO);
+
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)offsetof(QuadInstance, AxisX));
+            glVertexAttribDivisor(0, 1);
+
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)offsetof(QuadInstance, AxisY));
+            glVertexAttribDivisor(1, 1);
+
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)offsetof(QuadInstance, Translation));
+            glVertexAttribDivisor(2, 1);
+
+            glEnableVertexAttribArray(3);
+            glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(QuadInstance), (void*)offsetof(QuadInstance, Color));
+            glVertexAttribDivisor(3, 1);
+
+            glEnableVertexAttribArray(4);
+            glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)offsetof(QuadInstance, TexRect));
+            glVertexAttribDivisor(4, 1);
+
+            glEnableVertexAttribArray(5);
+            glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)offsetof(QuadInstance, TexIndex));
+            glVertexAttribDivisor(5, 1);
+
+            glEnableVertexAttribArray(6);
+            glVertexAttribPointer(6, 1, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)offsetof(QuadInstance, TilingFactor));
+            glVertexAttribDivisor(6, 1);
+
+            glEnableVertexAttribArray(7);
+            glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)offsetof(QuadInstance, Shape));
+            glVertexAttribDivisor(7, 1);
+
+            s_BatchData.InstanceShaders = CreateBatchShaders("BatchInstanceShader", "Shaders/BatchInstanceVertex.glsl");
+            s_BatchData.EdgeShaders = CreateBatchShaders("BatchEdgeShader", "Shaders/BatchInstanceVertex.glsl", "#define BATCH_EDGE_AA\n");
+        }
+
+        glCreateVertexArrays(1, &s_BatchData.LineVAO);
+        GLStateCache::BindVertexArray(s_BatchData.LineVAO);
+        {
+            glCreateBuffers(1, &s_BatchData.LineVBO);
+            GLStateCache::BindBuffer(GL_ARRAY_BUFFER, s_BatchData.LineVBO);
+            glBufferData(GL_ARRAY_BUFFER, LINE_BUFFER_SIZE, nullptr, GL_STREAM_DRAW);
+
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(LineVertex), (void*)offsetof(LineVertex, Position));
+
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(LineVertex), (void*)offsetof(LineVertex, Color));
+
+            for(std::vector<LineVertex>& vertices : s_BatchData.LineVertices)
+                vertices.reserve(MAX_LINE_VERTICES);
+
+            s_BatchData.LineShader = std::make_shared<Shader>("BatchLineShader", "Shaders/LineVertex.glsl", "Shaders/LineFragment.glsl");
+        }
+
+        glCreateVertexArrays(1, &s_BatchData.PointVAO);
+        GLStateCache::BindVertexArray(s_BatchData.PointVAO);
+        {
+            glCreateBuffers(1, &s_BatchData.PointVBO);
+            GLStateCache::BindBuffer(GL_ARRAY_BUFFER, s_BatchData.PointVBO);
+            glBufferData(GL_ARRAY_BUFFER, POINT_BUFFER_SIZE, nullptr, GL_STREAM_DRAW);
+
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PointVertex), (void*)offsetof(PointVertex, Position));
+
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PointVertex), (void*)offsetof(PointVertex, Color));
+
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(PointVertex), (void*)offsetof(PointVertex, Size));
+
+            s_BatchData.PointVertices.reserve(MAX_POINTS);
+            s_BatchData.PointShader = std::make_shared<Shader>("BatchPointShader", "Shaders/PointVertex.glsl", "Shaders/PointFragment.glsl");
+
+            // Lets the point shader size its points, nothing in the core ever turns it off again.
+            GLStateCache::Enable(GL_PROGRAM_POINT_SIZE);
+        }
+        GLStateCache::BindVertexArray(0);
+    }
+
+    void BatchRenderer::Quit() 
+    {
+        for(GLsync& fence : s_BatchData.RegionFences) 
+        {
+            if(fence != nullptr)
+                glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        if(s_BatchData.Streaming) 
+        {
+            glUnmapNamedBuffer(s_BatchData.QuadVBO);
+            s_BatchData.MappedBuffer = nullptr;
+        }
+        else 
         {
-            glCreateBuffers(1, &s_BatchData.QuadVBO);
-            glBindBuffer(GL_ARRAY_BUFFER, s_BatchData.QuadVBO);
-            glBufferData(GL_ARRAY_BUFFER, MAX_VERTICES * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
-            {
-                glEnableVertexAttribArray(0);
-                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Position));
+            delete[] s_BatchData.RegionBuffer;
+        }
 
-                glEnableVertexAttribArray(1);
-                glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Color));
+        s_BatchData.RegionBuffer = nullptr;
+        s_BatchData.BufferPtr = nullptr;
+
+        if(s_BatchData.HandleBuffer != 0)
+            GLStateCache::DeleteBuffer(s_BatchData.HandleBuffer);
+
+        if(s_BatchData.IndirectBuffer != 0)
+            GLStateCache::DeleteBuffer(s_BatchData.IndirectBuffer);
+
+        GLStateCache::DeleteBuffer(s_BatchData.LineVBO);
+        GLStateCache::DeleteVertexArray(s_BatchData.LineVAO);
+        s_BatchData.LineVBO = 0;
+        s_BatchData.LineVAO = 0;
+        for(std::vector<LineVertex>& vertices : s_BatchData.LineVertices)
+            vertices.clear();
+
+        GLStateCache::DeleteBuffer(s_BatchData.PointVBO);
+        GLStateCache::DeleteVertexArray(s_BatchData.PointVAO);
+        s_BatchData.PointVBO = 0;
+        s_BatchData.PointVAO = 0;
+        s_BatchData.PointVertices.clear();
+        s_BatchData.PointRuns.clear();
+
+        s_BatchData.IndirectBuffer = 0;
+        s_BatchData.IndirectCommands.clear();
+        s_BatchData.PendingRegions.clear();
+
+        s_BatchData.HandleBuffer = 0;
+        s_BatchData.BindlessTextures.clear();
+        s_BatchData.BindlessHandles.clear();
+        s_BatchData.BindlessLookup.clear();
+        s_BatchData.TextureArrays.Clear();
+    }
 
-                glEnableVertexAttribArray(2);
-                glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+    void BatchRenderer::SetRenderMode(BatchRenderMode mode) 
+    {
+        DVIMANA_ASSERT(s_BatchData.IndexCount == 0, "Render mode can't be changed inside a batch!");
+        s_BatchData.Mode = mode;
+    }
 
-                glEnableVertexAttribArray(3);
-                glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexIndex));
+    BatchRenderMode BatchRenderer::GetRenderMode() 
+    {
+        return s_BatchData.Mode;
+    }
 
-                glEnableVertexAttribArray(4);
-                glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TilingFactor));
-            }
+    void BatchRenderer::SetVertexLayout(BatchVertexLayout layout) 
+    {
+        DVIMANA_ASSERT(s_BatchData.IndexCount == 0, "Vertex layout can't be changed inside a batch!");
+        s_BatchData.Layout = layout;
+    }
 
-            int32_t indices[MAX_INDICES];
-            uint32_t offset = 0;
-            for(uint32_t i = 0; i < MAX_INDICES; i += 6){
-                indices[i + 0] = offset + 0;
-                indices[i + 1] = offset + 1;
-                indices[i + 2] = offset + 2;
+    BatchVertexLayout BatchRenderer::GetVertexLayout() 
+    {
+        return s_BatchData.Layout;
+    }
 
-                indices[i + 3] = offset + 2;
-                indices[i + 4] = offset + 3;
-                indices[i + 5] = offset + 0;
+    BatchTextureBackend BatchRenderer::GetTextureBackend() 
+    {
+        return s_BatchData.TextureBackend;
+    }
 
-                offset += 4;
-            }
+    void BatchRenderer::SetSubmission(BatchSubmission submission) 
+    {
+        DVIMANA_ASSERT(s_BatchData.IndexCount == 0 && s_BatchData.PendingRegions.empty(), "Submission can't be changed inside a batch!");
+        if(submission == BatchSubmission::Indirect && s_BatchData.IndirectBuffer == 0)
+            return;
 
-            glCreateBuffers(1, &s_BatchData.QuadIBO);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_BatchData.QuadIBO);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, MAX_INDICES * sizeof(uint32_t), indices, GL_STATIC_DRAW);
+        s_BatchData.Submission = submission;
+    }
 
-            for(uint32_t i = 0; i < MAX_TEXTURE_SLOTS; i++)
-                s_BatchData.TextureSlots[i] = nullptr;
+    BatchSubmission BatchRenderer::GetSubmission() 
+    {
+        return s_BatchData.Submission;
+    }
 
-            s_BatchData.PlainTexture = std::make_shared<Texture>(1, 1);
-            s_BatchData.TextureSlots[0] = s_BatchData.PlainTexture;
+    void BatchRenderer::SetCulling(bool enabled) 
+    {
+        s_BatchData.Culling = enabled;
+    }
 
-            s_BatchData.BatchShader = std::make_shared<Shader>("BatchShader", "Shaders/BatchVertex.glsl", "Shaders/BatchFragment.glsl");
+    bool BatchRenderer::GetCulling() 
+    {
+        return s_BatchData.Culling;
+    }
 
-            s_BatchData.QuadVertexPositions[0] = { -0.5f, -0.5f, 0.0f, 1.0f };
-            s_BatchData.QuadVertexPositions[1] = {  0.5f, -0.5f, 0.0f, 1.0f };
-            s_BatchData.QuadVertexPositions[2] = {  0.5f,  0.5f, 0.0f, 1.0f };
-            s_BatchData.QuadVertexPositions[3] = { -0.5f,  0.5f, 0.0f, 1.0f };
-        }
-        glBindVertexArray(0);
+    void BatchRenderer::SetEdgeAntialiasing(bool enabled) 
+    {
+        DVIMANA_ASSERT(s_BatchData.IndexCount == 0 && s_BatchData.QueuedQuads.empty(), "Edge anti-aliasing can't be changed inside a batch!");
+        s_BatchData.EdgeAntialiasing = enabled;
     }
 
-    void BatchRenderer::Quit() 
+    bool BatchRenderer::GetEdgeAntialiasing() 
     {
-        delete[] s_BatchData.QuadBuffer;
+        return s_BatchData.EdgeAntialiasing;
     }
 
     void BatchRenderer::Begin(const Camera2D& camera) 
     {
-        s_BatchData.BatchShader->Bind();
-        s_BatchData.BatchShader->Uniform("u_MVP", camera.ViewProjectionMatrix());
-
-        uint32_t texture_location = s_BatchData.BatchShader->GetUniformLocation("u_Textures");
-        int32_t samplers[MAX_TEXTURE_SLOTS];
-        for(uint32_t i = 0; i < MAX_TEXTURE_SLOTS; i++) 
-            samplers[i] = i;
-
-        glUniform1iv(texture_location, MAX_TEXTURE_SLOTS, samplers);
-        s_BatchData.QuadBufferPtr = s_BatchData.QuadBuffer;
+        StartBatch(camera.ViewMatrix(), camera.ProjectionMatrix());
     }
 
     void BatchRenderer::Begin(const Camera& camera, const glm::mat4& transform) 
     {
-        glm::mat4 MVP = camera.GetProjectionMatirx() * glm::inverse(transform);
-        s_BatchData.BatchShader->Bind();
-        s_BatchData.BatchShader->Uniform("u_MVP", MVP);
-
-        uint32_t texture_location = s_BatchData.BatchShader->GetUniformLocation("u_Textures");
-        int32_t samplers[MAX_TEXTURE_SLOTS];
-        for (uint32_t i = 0; i < MAX_TEXTURE_SLOTS; i++)
-            samplers[i] = i;
-            
-        glUniform1iv(texture_location, MAX_TEXTURE_SLOTS, samplers);
-        s_BatchData.QuadBufferPtr = s_BatchData.QuadBuffer;
+        StartBatch(glm::inverse(transform), camera.GetProjectionMatirx());
     }
 
     void BatchRenderer::End() 
     {
-        GLsizeiptr size = (uint8_t*)s_BatchData.QuadBufferPtr - (uint8_t*)s_BatchData.QuadBuffer;
-        glBindBuffer(GL_ARRAY_BUFFER, s_BatchData.QuadVBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, size, s_BatchData.QuadBuffer);
-        Flush();
+        DVI_PROFILE_SCOPE("BatchRenderer::End");
+        bool emitted = !s_BatchData.QueuedQuads.empty();
+        if(emitted)
+            EmitQueue();
+
+        SubmitRegion();
+        IssueIndirect();
+
+        if(emitted)
+            GLStateCache::Enable(GL_BLEND);
+        if(emitted || EdgeAntialiased())
+            GLStateCache::DepthMask(true);
+
+        FlushPoints();
+        FlushLines();
     }
 
     void BatchRenderer::Flush() 
     {
-        for(uint32_t i = 0; i < s_BatchData.TextureSlotIndex; i++) 
-        {
-            s_BatchData.TextureSlots[i]->Bind(i);
-		}
+        BindBatchPipeline();
+        BindBatchVertexArray();
 
-		glBindVertexArray(s_BatchData.QuadVAO);
-		glDrawElements(GL_TRIANGLES, s_BatchData.IndexCount, GL_UNSIGNED_INT, nullptr);
+        DrawElementsIndirectCommand command = RegionCommand();
+        if(s_BatchData.Mode == BatchRenderMode::Instanced)
+            glDrawElementsInstancedBaseInstance(GL_TRIANGLES, command.Count, s_BatchData.IndexType, nullptr, command.InstanceCount, command.BaseInstance);
+        else
+            glDrawElementsBaseVertex(GL_TRIANGLES, command.Count, s_BatchData.IndexType, nullptr, command.BaseVertex);
 
         s_BatchData.Status.DrawCount++;
 		s_BatchData.IndexCount = 0;
-		s_BatchData.TextureSlotIndex = 1;
+		ResetTextureTable();
     }
 
     void BatchRenderer::Quad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color) 
@@ -240,182 +1371,555 @@ namespace DviCore
     }
 
     void BatchRenderer::Quad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color, const std::shared_ptr<Texture>& texture, float rotation, float tiling_factor) 
-    {           
-        if (s_BatchData.IndexCount >= MAX_INDICES || s_BatchData.TextureSlotIndex >= MAX_TEXTURE_SLOTS) 
+    {
+        Submit(QuadKernel::Affine(position, size, rotation), color, DEFAULT_TEX_COORDS, texture, tiling_factor);
+    }
+
+    void BatchRenderer::Quad(const glm::vec3& position, const glm::vec2& size, const std::shared_ptr<SubTexture>& texture) 
+    {
+        Quad(position, size, DEFAULT_COLOR, texture, 0.0f, 1.0f);
+    }
+
+    void BatchRenderer::Quad(const glm::vec3& position, const glm::vec2& size, const std::shared_ptr<SubTexture>& texture, float rotation) 
+    {
+        Quad(position, size, DEFAULT_COLOR, texture, rotation, 1.0f);
+    }
+
+    void BatchRenderer::Quad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color, const std::shared_ptr<SubTexture>& texture, float rotation, float tiling_factor) 
+    {
+        Submit(QuadKernel::Affine(position, size, rotation), color, texture->GetTexCoords(), texture->TexturePtr(), tiling_factor);
+    }
+
+    void BatchRenderer::Quad(const glm::mat4& transform, const glm::vec4& color) 
+    {
+        Quad(transform, s_BatchData.PlainTexture, color, 1.0f);
+    }
+
+    void BatchRenderer::Quad(const glm::mat4& transform, const std::shared_ptr<Texture>& texture, const glm::vec4& tint, float tiling) 
+    {
+        Submit(QuadKernel::Affine(transform), tint, DEFAULT_TEX_COORDS, texture, tiling);
+    }
+
+    void BatchRenderer::Quad(const glm::mat4& transform, const std::shared_ptr<SubTexture>& texture, const glm::vec4& tint, float tiling) 
+    {
+        Submit(QuadKernel::Affine(transform), tint, texture->GetTexCoords(), texture->TexturePtr(), tiling);
+    }
+
+    struct BatchRenderer::QuadStream 
+    {
+        const uint8_t* Transforms{ nullptr };
+        size_t TransformStride{ sizeof(glm::mat4) };
+        const uint8_t* Colors{ nullptr };
+        size_t ColorStride{ sizeof(glm::vec4) };
+        const uint8_t* Textures{ nullptr };
+        size_t TextureStride{ sizeof(std::shared_ptr<Texture>) };
+        const uint8_t* TilingFactors{ nullptr };
+        size_t TilingStride{ sizeof(float) };
+    };
+
+    void BatchRenderer::Quads(std::span<const QuadSubmission> quads) 
+    {
+        if(quads.empty())
+            return;
+
+        const uint8_t* base = reinterpret_cast<const uint8_t*>(quads.data());
+        QuadStream stream;
+        stream.Transforms       = base + offsetof(QuadSubmission, Transform);
+        stream.TransformStride  = sizeof(QuadSubmission);
+        stream.Colors           = base + offsetof(QuadSubmission, Color);
+        stream.ColorStride      = sizeof(QuadSubmission);
+        stream.Textures         = base + offsetof(QuadSubmission, TexturePtr);
+        stream.TextureStride    = sizeof(QuadSubmission);
+        stream.TilingFactors    = base + offsetof(QuadSubmission, TilingFactor);
+        stream.TilingStride     = sizeof(QuadSubmission);
+        Submit(stream, quads.size());
+    }
+
+    void BatchRenderer::Quads(std::span<const glm::mat4> transforms, std::span<const glm::vec4> colors, std::span<const std::shared_ptr<Texture>> textures) 
+    {
+        DVIMANA_ASSERT(colors.size() == transforms.size(), "Every quad needs a color!");
+        DVIMANA_ASSERT(textures.empty() || textures.size() == transforms.size(), "Every quad needs a texture!");
+
+        QuadStream stream;
+        stream.Transforms   = reinterpret_cast<const uint8_t*>(transforms.data());
+        stream.Colors       = reinterpret_cast<const uint8_t*>(colors.data());
+        stream.Textures     = textures.empty() ? nullptr : reinterpret_cast<const uint8_t*>(textures.data());
+        Submit(stream, transforms.size());
+    }
+
+    // Splits the submission only where the batch really runs out of quads or texture slots, everything in between is
+    // written as one chunk with a single pass of the corner kernel.
+    void BatchRenderer::Submit(const QuadStream& stream, size_t count) 
+    {
+        // With culling on, the affines are built up front so rejected quads never reach texture resolution or the buffer.
+        const uint32_t* indices = nullptr;
+        if(s_BatchData.Culling) 
         {
-            Restart();
+            s_BatchData.CullAffines.clear();
+            s_BatchData.CullIndices.clear();
+            for(size_t i = 0; i < count; i++) 
+            {
+                QuadAffine quad = QuadKernel::Affine(StreamAt<glm::mat4>(stream.Transforms, stream.TransformStride, i));
+                if(!InFrustum(quad, s_BatchData.FrustumPlanes))
+                    continue;
+
+                s_BatchData.CullAffines.push_back(quad);
+                s_BatchData.CullIndices.push_back(static_cast<uint32_t>(i));
+            }
+
+            s_BatchData.Status.CulledCount += static_cast<uint32_t>(count - s_BatchData.CullIndices.size());
+            indices = s_BatchData.CullIndices.data();
+            count = s_BatchData.CullIndices.size();
         }
 
-        float texture_index = 0.0f;
-        for(uint32_t i = 1; i < s_BatchData.TextureSlotIndex; i++) 
+        auto source = [indices](size_t i) { return indices ? indices[i] : i; };
+
+        if(s_BatchData.Queued) 
         {
-			if (s_BatchData.TextureSlots[i] == texture) 
+            static const std::shared_ptr<Texture> no_texture{ nullptr };
+            for(size_t i = 0; i < count; i++) 
             {
-				texture_index = static_cast<float>(i);
-				break;
-			}
-		}
+                size_t index = source(i);
+                QuadAffine quad = indices ? s_BatchData.CullAffines[i] : QuadKernel::Affine(StreamAt<glm::mat4>(stream.Transforms, stream.TransformStride, index));
+                const glm::vec4& color = StreamAt<glm::vec4>(stream.Colors, stream.ColorStride, index);
+                const std::shared_ptr<Texture>& texture = stream.Textures ? StreamAt<std::shared_ptr<Texture>>(stream.Textures, stream.TextureStride, index) : no_texture;
+                float tiling_factor = stream.TilingFactors ? StreamAt<float>(stream.TilingFactors, stream.TilingStride, index) : 1.0f;
+                QueueQuad(quad, color, DEFAULT_TEX_COORDS, texture, tiling_factor);
+            }
+
+            return;
+        }
 
-        if(texture_index == 0.0f) 
+        size_t first = 0;
+        while(first < count) 
         {
-			texture_index = static_cast<float>(s_BatchData.TextureSlotIndex);
-			s_BatchData.TextureSlots[s_BatchData.TextureSlotIndex] = texture;
-			s_BatchData.TextureSlotIndex++;
-		}
+            size_t capacity = (MAX_INDICES - s_BatchData.IndexCount) / 6;
+            size_t chunk = std::min(count - first, capacity);
+            if(chunk > 0)
+                chunk = ResolveTextureSlots(stream.Textures, stream.TextureStride, indices, first, chunk);
 
-        glm::mat4 transform = glm::translate(glm::mat4(1.0f), position)     * 
-            glm::rotate(glm::mat4(1.0f), rotation, { 0.0f, 0.0f, 1.0f })    * 
-            glm::scale(glm::mat4(1.0f), { size.x, size.y, 1.0f });
+            if(chunk == 0) 
+            {
+                Restart();
+                continue;
+            }
 
-		for(uint32_t i = 0; i < MAX_QUAD_VERTEX_COUNT; i++) 
-        {
-			s_BatchData.QuadBufferPtr->Position             = transform * s_BatchData.QuadVertexPositions[i];
-			s_BatchData.QuadBufferPtr->Color                = color;
-			s_BatchData.QuadBufferPtr->TexCoords            = DEFAULT_TEX_COORDS[i];
-			s_BatchData.QuadBufferPtr->TexIndex             = texture_index;
-			s_BatchData.QuadBufferPtr->TilingFactor         = tiling_factor;
-			s_BatchData.QuadBufferPtr++;
-		}
+            QuadAffine* affines = s_BatchData.BulkAffines.data();
+            if(indices) 
+            {
+                affines = s_BatchData.CullAffines.data() + first;
+            }
+            else 
+            {
+                for(size_t i = 0; i < chunk; i++)
+                    affines[i] = QuadKernel::Affine(StreamAt<glm::mat4>(stream.Transforms, stream.TransformStride, first + i));
+            }
+
+            glm::vec3* corners = nullptr;
+            if(s_BatchData.Mode != BatchRenderMode::Instanced) 
+            {
+                corners = s_BatchData.BulkCorners.data();
+                QuadKernel::Corners(affines, chunk, corners);
+            }
+
+            size_t quad_bytes = QuadBytes(s_BatchData.Mode, s_BatchData.Layout);
+            for(size_t i = 0; i < chunk; i++) 
+            {
+                size_t index = source(first + i);
+                const glm::vec4& color = StreamAt<glm::vec4>(stream.Colors, stream.ColorStride, index);
+                float tiling_factor = stream.TilingFactors ? StreamAt<float>(stream.TilingFactors, stream.TilingStride, index) : 1.0f;
+                const glm::vec3* quad_corners = corners ? corners + i * MAX_QUAD_VERTEX_COUNT : nullptr;
+
+                if(stream.Textures)
+                    WriteQuadData<true>(s_BatchData.BufferPtr, s_BatchData.Mode, s_BatchData.Layout, affines[i], quad_corners, color, DEFAULT_TEX_COORDS, s_BatchData.BulkSlots[i], tiling_factor);
+                else
+                    WriteQuadData<false>(s_BatchData.BufferPtr, s_BatchData.Mode, s_BatchData.Layout, affines[i], quad_corners, color, DEFAULT_TEX_COORDS, 0.0f, 1.0f);
+                s_BatchData.BufferPtr += quad_bytes;
+            }
 
-		s_BatchData.IndexCount += 6;
-		s_BatchData.Status.QuadCount++;
+            s_BatchData.IndexCount += static_cast<uint32_t>(chunk * 6);
+            s_BatchData.Status.QuadCount += static_cast<uint32_t>(chunk);
+            first += chunk;
+        }
     }
 
-    void BatchRenderer::Quad(const glm::vec3& position, const glm::vec2& size, const std::shared_ptr<SubTexture>& texture) 
+    // Maps a recorded segment's local texture slots onto the batch, identity means the recorded indices can be kept as-is.
+    static bool MapTextureSlots(const std::vector<std::shared_ptr<Texture>>& textures, uint32_t texture_count, float* remap, bool& identity) 
     {
-        Quad(position, size, DEFAULT_COLOR, texture, 0.0f, 1.0f);
+        remap[0] = 0.0f;
+        identity = true;
+        for(uint32_t i = 1; i < texture_count; i++) 
+        {
+            if(!ResolveTexture(textures[i], remap[i]))
+                return false;
+
+            identity = identity && remap[i] == static_cast<float>(i);
+        }
+
+        return true;
     }
 
-    void BatchRenderer::Quad(const glm::vec3& position, const glm::vec2& size, const std::shared_ptr<SubTexture>& texture, float rotation) 
+    static void CopyQuads(const uint8_t* source, uint8_t* destination, size_t quad_count, BatchRenderMode mode, BatchVertexLayout layout, const float* remap) 
     {
-        Quad(position, size, DEFAULT_COLOR, texture, rotation, 1.0f);
+        std::memcpy(destination, source, quad_count * QuadBytes(mode, layout));
+        if(remap == nullptr)
+            return;
+
+        // Only the destination is written here, the mapped buffer is write-combined and must never be read back.
+        if(mode == BatchRenderMode::Instanced) 
+        {
+            const QuadInstance* from = reinterpret_cast<const QuadInstance*>(source);
+            QuadInstance* to = reinterpret_cast<QuadInstance*>(destination);
+            for(size_t i = 0; i < quad_count; i++)
+                to[i].TexIndex = remap[static_cast<uint32_t>(from[i].TexIndex)];
+        }
+        else if(layout == BatchVertexLayout::Compact) 
+        {
+            const CompactVertex* from = reinterpret_cast<const CompactVertex*>(source);
+            CompactVertex* to = reinterpret_cast<CompactVertex*>(destination);
+            for(size_t i = 0; i < quad_count * MAX_QUAD_VERTEX_COUNT; i++)
+                to[i].TexIndex = static_cast<uint16_t>(remap[from[i].TexIndex]);
+        }
+        else 
+        {
+            const Vertex* from = reinterpret_cast<const Vertex*>(source);
+            Vertex* to = reinterpret_cast<Vertex*>(destination);
+            for(size_t i = 0; i < quad_count * MAX_QUAD_VERTEX_COUNT; i++)
+                to[i].TexIndex = remap[static_cast<uint32_t>(from[i].TexIndex)];
+        }
     }
 
-    void BatchRenderer::Quad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color, const std::shared_ptr<SubTexture>& texture, float rotation, float tiling_factor) 
+    void BatchRenderer::Merge(const BatchRecorder& recorder) 
     {
-        if (s_BatchData.IndexCount >= MAX_INDICES || s_BatchData.TextureSlotIndex >= MAX_TEXTURE_SLOTS) 
+        if(recorder.m_Mode != s_BatchData.Mode || recorder.m_Layout != s_BatchData.Layout) 
         {
-			Restart();
-		}
+            DVIMANA_ASSERT(false, "Batch recorder was reset with a different render mode or vertex layout!");
+            return;
+        }
 
-        const glm::vec2* tex_coords = texture->GetTexCoords();
-        float texture_index = 0.0f;
+        s_BatchData.Status.CulledCount += recorder.m_CulledCount;
 
-        for (uint32_t i = 1; i < s_BatchData.TextureSlotIndex; i++) 
+        for(const BatchRecorder::Segment& segment : recorder.m_Segments) 
         {
-            if (s_BatchData.TextureSlots[i] == texture->TexturePtr()) {
-                texture_index = static_cast<float>(i);
-                break;
+            // Recorded quads in slot 0 aren't tracked, so the plain texture is assumed to be in use.
+            s_BatchData.PlainUsed = true;
+            float remap[MAX_TEXTURE_SLOTS];
+            bool identity = true;
+
+            bool fits = s_BatchData.IndexCount + segment.QuadCount * 6 <= MAX_INDICES;
+            if(!fits || !MapTextureSlots(segment.Textures, segment.TextureCount, remap, identity)) 
+            {
+                Restart();
+                MapTextureSlots(segment.Textures, segment.TextureCount, remap, identity);
             }
+
+            CopyQuads(recorder.m_Data.data() + segment.Offset, s_BatchData.BufferPtr, segment.QuadCount, s_BatchData.Mode, s_BatchData.Layout, identity ? nullptr : remap);
+            s_BatchData.BufferPtr += segment.QuadCount * recorder.m_QuadBytes;
+            s_BatchData.IndexCount += segment.QuadCount * 6;
+            s_BatchData.Status.QuadCount += segment.QuadCount;
         }
+    }
 
-        if(texture_index == 0.0f) 
-        {
-			texture_index = static_cast<float>(s_BatchData.TextureSlotIndex);
-			s_BatchData.TextureSlots[s_BatchData.TextureSlotIndex] = texture->TexturePtr();
-			s_BatchData.TextureSlotIndex++;
-		}
+    BatchRecorder::BatchRecorder() 
+    {
+        Reset();
+    }
 
-        glm::mat4 transform = glm::translate(glm::mat4(1.0f), position)     * 
-			glm::rotate(glm::mat4(1.0f), rotation, { 0.0f, 0.0f, 1.0f })    * 
-			glm::scale(glm::mat4(1.0f), { size.x, size.y, 1.0f });
+    void BatchRecorder::Reset() 
+    {
+        m_Mode = BatchRenderer::GetRenderMode();
+        m_Layout = BatchRenderer::GetVertexLayout();
+        m_QuadBytes = QuadBytes(m_Mode, m_Layout);
+        m_Culling = s_BatchData.Culling;
+        m_FrustumPlanes = s_BatchData.FrustumPlanes;
+        m_DataSize = 0;
+        m_Segments.clear();
+        m_QuadCount = 0;
+        m_CulledCount = 0;
+    }
 
-		for (uint32_t i = 0; i < MAX_QUAD_VERTEX_COUNT; i++) 
-        {
-			s_BatchData.QuadBufferPtr->Position         = transform * s_BatchData.QuadVertexPositions[i];
-			s_BatchData.QuadBufferPtr->Color            = color;
-			s_BatchData.QuadBufferPtr->TexCoords        = tex_coords[i];
-			s_BatchData.QuadBufferPtr->TexIndex         = texture_index;
-			s_BatchData.QuadBufferPtr->TilingFactor     = tiling_factor;
-			s_BatchData.QuadBufferPtr++;
-		}
+    // Axis aligned, so the affine is built directly instead of paying for the rotation.
+    void BatchRecorder::Quad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color) 
+    {
+        QuadAffine quad;
+        quad.AxisX          = { size.x, 0.0f, 0.0f };
+        quad.AxisY          = { 0.0f, size.y, 0.0f };
+        quad.Translation    = position;
+        Write(quad, color, DEFAULT_TEX_COORDS, nullptr, 1.0f);
+    }
 
-		s_BatchData.IndexCount += 6;
-		s_BatchData.Status.QuadCount++;
+    void BatchRecorder::Quad(const glm::mat4& transform, const glm::vec4& color) 
+    {
+        Write(QuadKernel::Affine(transform), color, DEFAULT_TEX_COORDS, nullptr, 1.0f);
     }
 
-    void BatchRenderer::Quad(const glm::mat4& transform, const glm::vec4& color) 
+    void BatchRecorder::Quad(const glm::mat4& transform, const std::shared_ptr<Texture>& texture, const glm::vec4& tint, float tiling) 
     {
-        Quad(transform, s_BatchData.PlainTexture, color, 1.0f);
+        Write(QuadKernel::Affine(transform), tint, DEFAULT_TEX_COORDS, texture, tiling);
     }
 
-    void BatchRenderer::Quad(const glm::mat4& transform, const std::shared_ptr<Texture>& texture, const glm::vec4& tint, float tiling) 
+    void BatchRecorder::Quad(const glm::mat4& transform, const std::shared_ptr<SubTexture>& texture, const glm::vec4& tint, float tiling) 
     {
-        if (s_BatchData.IndexCount >= MAX_INDICES || s_BatchData.TextureSlotIndex >= MAX_TEXTURE_SLOTS) {
-            Restart();
+        Write(QuadKernel::Affine(transform), tint, texture->GetTexCoords(), texture->TexturePtr(), tiling);
+    }
+
+    void BatchRecorder::Quads(std::span<const QuadSubmission> quads) 
+    {
+        for(const QuadSubmission& quad : quads)
+            Write(QuadKernel::Affine(quad.Transform), quad.Color, DEFAULT_TEX_COORDS, quad.TexturePtr, quad.TilingFactor);
+    }
+
+    void BatchRecorder::Quads(std::span<const glm::mat4> transforms, std::span<const glm::vec4> colors, std::span<const std::shared_ptr<Texture>> textures) 
+    {
+        DVIMANA_ASSERT(colors.size() == transforms.size(), "Every quad needs a color!");
+        DVIMANA_ASSERT(textures.empty() || textures.size() == transforms.size(), "Every quad needs a texture!");
+
+        static const std::shared_ptr<Texture> no_texture{ nullptr };
+        for(size_t i = 0; i < transforms.size(); i++)
+            Write(QuadKernel::Affine(transforms[i]), colors[i], DEFAULT_TEX_COORDS, textures.empty() ? no_texture : textures[i], 1.0f);
+    }
+
+    void BatchRecorder::Write(const QuadAffine& quad, const glm::vec4& color, const glm::vec2* tex_coords, const std::shared_ptr<Texture>& texture, float tiling_factor) 
+    {
+        if(m_Culling && !InFrustum(quad, m_FrustumPlanes)) 
+        {
+            m_CulledCount++;
+            return;
         }
 
-        float texture_index = 0.0f;
-        for (uint32_t i = 1; i < s_BatchData.TextureSlotIndex; i++) 
+        uint32_t slot = 0;
+        if(m_Segments.empty() || m_Segments.back().QuadCount >= MAX_QUADS || !Slot(texture, slot)) 
         {
-            if (s_BatchData.TextureSlots[i] == texture) 
-            {
-                texture_index = static_cast<float>(i);
-                break;
-            }
+            OpenSegment();
+            Slot(texture, slot);
         }
 
-        if (texture_index == 0.0f) 
+        if(m_DataSize + m_QuadBytes > m_Data.size())
+            m_Data.resize(std::max(m_Data.size() * 2, m_QuadBytes * MAX_QUADS));
+
+        if(slot == 0)
+            WriteQuadData<false>(m_Data.data() + m_DataSize, m_Mode, m_Layout, quad, nullptr, color, tex_coords, 0.0f, 1.0f);
+        else
+            WriteQuadData<true>(m_Data.data() + m_DataSize, m_Mode, m_Layout, quad, nullptr, color, tex_coords, static_cast<float>(slot), tiling_factor);
+        m_DataSize += m_QuadBytes;
+        m_Segments.back().QuadCount++;
+        m_QuadCount++;
+    }
+
+    bool BatchRecorder::Slot(const std::shared_ptr<Texture>& texture, uint32_t& slot) 
+    {
+        if(texture == nullptr || texture == s_BatchData.PlainTexture) 
         {
-            texture_index = static_cast<float>(s_BatchData.TextureSlotIndex);
-            s_BatchData.TextureSlots[s_BatchData.TextureSlotIndex] = texture;
-            s_BatchData.TextureSlotIndex++;
+            slot = 0;
+            return true;
         }
 
+        Segment& segment = m_Segments.back();
+        return FindTextureSlot(segment.Textures.data(), segment.TextureCount, texture, slot);
+    }
+
+    void BatchRecorder::OpenSegment() 
+    {
+        Segment& segment = m_Segments.emplace_back();
+        segment.Offset = m_DataSize;
+        segment.Textures.resize(MAX_TEXTURE_SLOTS);
+    }
 
-        for (uint32_t i = 0; i < MAX_QUAD_VERTEX_COUNT; i++) 
+    void BatchRenderer::Submit(const QuadAffine& quad, const glm::vec4& color, const glm::vec2* tex_coords, const std::shared_ptr<Texture>& texture, float tiling_factor, 
+        const glm::vec4& shape) 
+    {
+        if(s_BatchData.Culling && !InFrustum(quad, s_BatchData.FrustumPlanes)) 
         {
-            s_BatchData.QuadBufferPtr->Position         = transform * s_BatchData.QuadVertexPositions[i];
-            s_BatchData.QuadBufferPtr->Color            = tint;
-            s_BatchData.QuadBufferPtr->TexCoords        = DEFAULT_TEX_COORDS[i];
-            s_BatchData.QuadBufferPtr->TexIndex         = texture_index;
-            s_BatchData.QuadBufferPtr->TilingFactor     = tiling;
-            s_BatchData.QuadBufferPtr++;
+            s_BatchData.Status.CulledCount++;
+            return;
         }
 
-        s_BatchData.IndexCount += 6;
-        s_BatchData.Status.QuadCount++;
+        if(s_BatchData.Queued)
+            QueueQuad(quad, color, tex_coords, texture, tiling_factor, shape);
+        else
+            Write(quad, color, tex_coords, texture, tiling_factor, shape);
     }
 
-    void BatchRenderer::Quad(const glm::mat4& transform, const std::shared_ptr<SubTexture>& texture, const glm::vec4& tint, float tiling) 
+    void BatchRenderer::Write(const QuadAffine& quad, const glm::vec4& color, const glm::vec2* tex_coords, const std::shared_ptr<Texture>& texture, float tiling_factor, 
+        const glm::vec4& shape) 
     {
-        if (s_BatchData.IndexCount >= MAX_INDICES || s_BatchData.TextureSlotIndex >= MAX_TEXTURE_SLOTS) 
+        if (s_BatchData.IndexCount >= MAX_INDICES) 
         {
             Restart();
         }
 
-        const glm::vec2* tex_coords = texture->GetTexCoords();
+        // Untextured quads skip the slot search entirely.
+        if(texture == nullptr || texture == s_BatchData.PlainTexture) 
+        {
+            s_BatchData.PlainUsed = true;
+            WriteQuad<false>(quad, color, tex_coords, 0.0f, 1.0f, shape);
+            return;
+        }
+
         float texture_index = 0.0f;
+        if(!ResolveTexture(texture, texture_index)) 
+        {
+            Restart();
+            ResolveTexture(texture, texture_index);
+        }
+
+        WriteQuad<true>(quad, color, tex_coords, texture_index, tiling_factor, shape);
+    }
+
+    void BatchRenderer::EmitQueue() 
+    {
+        DVI_PROFILE_SCOPE("BatchRenderer::EmitQueue");
+        const std::vector<uint32_t>& order = s_BatchData.Queue.Sort();
 
-        for (uint32_t i = 1; i < s_BatchData.TextureSlotIndex; i++) 
+        std::vector<uint32_t> bindings(s_BatchData.QueueTextures.size(), 0);
+        uint32_t capacity = MAX_TEXTURE_SLOTS - 1;
+        for(uint32_t i = 1; i < bindings.size(); i++) 
         {
-            if (s_BatchData.TextureSlots[i] == texture->TexturePtr()) 
+            bindings[i] = i;
+            if(s_BatchData.TextureBackend == BatchTextureBackend::Arrays) 
             {
-                texture_index = static_cast<float>(i);
-                break;
+                uint32_t array = s_BatchData.TextureArrays.Locate(s_BatchData.QueueTextures[i]).Array;
+                bindings[i] = array == s_BatchData.ArraySlots[0] ? 0 : array + 1;
             }
         }
 
-        if (texture_index == 0.0f) 
+        if(s_BatchData.TextureBackend == BatchTextureBackend::Bindless)
+            capacity = MAX_BINDLESS_TEXTURES - 1;
+
+        uint32_t submitted_batches = CountBatches(nullptr, bindings, capacity);
+        uint32_t sorted_batches = CountBatches(order.data(), bindings, capacity);
+        if(submitted_batches > sorted_batches)
+            s_BatchData.Status.FlushesAvoided += submitted_batches - sorted_batches;
+
+        // Quads written directly before this point still draw with the default blended state.
+        if(s_BatchData.IndexCount > 0)
+            Restart();
+
+        IssueIndirect();
+
+        // Opaque quads go first with blending off and depth writes on, front-to-back so early-Z rejects what they hide.
+        // Translucent quads follow back-to-front, blended and without writing depth.
+        bool translucent_pass = false;
+        SetPassState(false);
+        for(uint32_t index : order) 
         {
-            texture_index = static_cast<float>(s_BatchData.TextureSlotIndex);
-            s_BatchData.TextureSlots[s_BatchData.TextureSlotIndex] = texture->TexturePtr();
-            s_BatchData.TextureSlotIndex++;
+            const QueuedQuad& queued = s_BatchData.QueuedQuads[index];
+            if(queued.Translucent && !translucent_pass) 
+            {
+                if(s_BatchData.IndexCount > 0)
+                    Restart();
+
+                IssueIndirect();
+                SetPassState(true);
+                translucent_pass = true;
+            }
+
+            if(!queued.Translucent)
+                s_BatchData.Status.OpaqueCount++;
+
+            Write(queued.Quad, queued.Color, queued.TexCoords, s_BatchData.QueueTextures[queued.TextureId], queued.TilingFactor, queued.Shape);
         }
 
+        s_BatchData.Queue.Clear();
+        s_BatchData.QueuedQuads.clear();
+        s_BatchData.QueueTextures.resize(1);
+        s_BatchData.QueueTextureIds.clear();
+    }
+
+    void BatchRenderer::SetQueueSorting(bool enabled) 
+    {
+        DVIMANA_ASSERT(s_BatchData.IndexCount == 0 && s_BatchData.QueuedQuads.empty(), "Queue sorting can't be changed inside a batch!");
+        s_BatchData.Queued = enabled;
+    }
+
+    bool BatchRenderer::GetQueueSorting() 
+    {
+        return s_BatchData.Queued;
+    }
+
+    void BatchRenderer::SetSortLayer(uint8_t layer) 
+    {
+        s_BatchData.SortLayer = layer;
+    }
+
+    // Shapes are plain quads whose coverage the fragment shader evaluates from a rounded box distance. The shape carries the
+    // ring thickness, the edge fade and the corner radius as fractions of the shorter half side, and the quad's aspect ratio.
+    static glm::vec4 ShapeParameters(const QuadAffine& quad, float thickness, float fade, float radius) 
+    {
+        float width = glm::length(quad.AxisX), height = glm::length(quad.AxisY);
+        float aspect = height > 0.0f ? width / height : 1.0f;
+        return { std::clamp(thickness, 0.001f, 1.0f), std::max(fade, 0.0f), std::clamp(radius, 0.0f, 1.0f), aspect };
+    }
+
+    void BatchRenderer::Circle(const glm::mat4& transform, const glm::vec4& color, float thickness, float fade) 
+    {
+        QuadAffine quad = QuadKernel::Affine(transform);
+        Submit(quad, color, DEFAULT_TEX_COORDS, nullptr, 1.0f, ShapeParameters(quad, thickness, fade, 1.0f));
+    }
+
+    void BatchRenderer::RoundedRect(const glm::mat4& transform, const glm::vec4& color, float radius, float thickness, float fade) 
+    {
+        QuadAffine quad = QuadKernel::Affine(transform);
+        Submit(quad, color, DEFAULT_TEX_COORDS, nullptr, 1.0f, ShapeParameters(quad, thickness, fade, radius));
+    }
 
-        for (uint32_t i = 0; i < MAX_QUAD_VERTEX_COUNT; i++) 
+    // Glyph quads are marked by a negative shape thickness, the fragment shader then reads their coverage from the distance
+    // field in the atlas alpha instead of blending the texel.
+    void BatchRenderer::Glyphs(std::span<const GlyphQuad> glyphs, const std::shared_ptr<Texture>& atlas, const glm::mat4& transform, const glm::vec4& color) 
+    {
+        glm::vec3 axis_x = transform[0], axis_y = transform[1], origin = transform[3];
+        for(const GlyphQuad& glyph : glyphs) 
         {
-            s_BatchData.QuadBufferPtr->Position             = transform * s_BatchData.QuadVertexPositions[i];
-            s_BatchData.QuadBufferPtr->Color                = tint;
-            s_BatchData.QuadBufferPtr->TexCoords            = tex_coords[i];
-            s_BatchData.QuadBufferPtr->TexIndex             = texture_index;
-            s_BatchData.QuadBufferPtr->TilingFactor         = tiling;
-            s_BatchData.QuadBufferPtr++;
+            glm::vec2 size = glyph.Max - glyph.Min;
+            glm::vec2 center = (glyph.Min + glyph.Max) * 0.5f;
+
+            QuadAffine quad;
+            quad.AxisX = axis_x * size.x;
+            quad.AxisY = axis_y * size.y;
+            quad.Translation = origin + axis_x * center.x + axis_y * center.y;
+
+            // Atlas rows run top to bottom, the quad's first corner is its bottom left.
+            glm::vec2 tex_coords[MAX_QUAD_VERTEX_COUNT] = {
+                { glyph.TexMin.x, glyph.TexMax.y }, { glyph.TexMax.x, glyph.TexMax.y },
+                { glyph.TexMax.x, glyph.TexMin.y }, { glyph.TexMin.x, glyph.TexMin.y },
+            };
+
+            Submit(quad, color, tex_coords, atlas, 1.0f, GLYPH_SHAPE);
         }
+    }
 
-        s_BatchData.IndexCount += 6;
-        s_BatchData.Status.QuadCount++;
+    void BatchRenderer::Point(const glm::vec3& position, float size, const glm::vec4& color) 
+    {
+        Point(position, size, s_BatchData.PlainTexture, color);
+    }
+
+    void BatchRenderer::Point(const glm::vec3& position, float size, const std::shared_ptr<Texture>& texture, const glm::vec4& tint) 
+    {
+        const std::shared_ptr<Texture>& used_texture = texture != nullptr ? texture : s_BatchData.PlainTexture;
+        if(s_BatchData.PointRuns.empty() || s_BatchData.PointRuns.back().TexturePtr != used_texture)
+            s_BatchData.PointRuns.push_back({ used_texture, 0 });
+
+        s_BatchData.PointVertices.push_back({ position, glm::packUnorm4x8(tint), size });
+        s_BatchData.PointRuns.back().Count++;
+        s_BatchData.Status.PointCount++;
+    }
+
+    void BatchRenderer::Line(const glm::vec3& from, const glm::vec3& to, const glm::vec4& color, BatchLineMode mode) 
+    {
+        std::vector<LineVertex>& vertices = s_BatchData.LineVertices[static_cast<uint32_t>(mode)];
+        vertices.push_back({ from, color });
+        vertices.push_back({ to, color });
+        s_BatchData.Status.LineCount++;
+    }
+
+    void BatchRenderer::Rect(const glm::mat4& transform, const glm::vec4& color, BatchLineMode mode) 
+    {
+        glm::vec3 corners[MAX_QUAD_VERTEX_COUNT];
+        for(uint32_t i = 0; i < MAX_QUAD_VERTEX_COUNT; i++)
+            corners[i] = transform * glm::vec4(DEFAULT_TEX_COORDS[i] - 0.5f, 0.0f, 1.0f);
+
+        for(uint32_t i = 0; i < MAX_QUAD_VERTEX_COUNT; i++)
+            Line(corners[i], corners[(i + 1) % MAX_QUAD_VERTEX_COUNT], color, mode);
     }
 
     const BatchRenderer::RendererStatus& BatchRenderer::Status() 
@@ -427,13 +1931,35 @@ namespace DviCore
     {
         s_BatchData.Status.DrawCount = 0;
         s_BatchData.Status.QuadCount = 0;
+        s_BatchData.Status.FenceWaitCount = 0;
+        s_BatchData.Status.FenceWaitTime = 0.0f;
+        s_BatchData.Status.UploadBytes = 0;
+        s_BatchData.Status.FlushesAvoided = 0;
+        s_BatchData.Status.CulledCount = 0;
+        s_BatchData.Status.IndirectCommandCount = 0;
+        s_BatchData.Status.OpaqueCount = 0;
+        s_BatchData.Status.LineCount = 0;
+        s_BatchData.Status.LineDrawCount = 0;
+        s_BatchData.Status.PointCount = 0;
+        s_BatchData.Status.ColorOnlyDrawCount = 0;
+        s_BatchData.Status.SingleTextureDrawCount = 0;
     }
 
-    void Renderer::Init() 
+    static_assert(sizeof(FrameConstants) == 208, "Frame constants must match their std140 block!");
+
+    struct FrameData 
+    {
+        uint32_t UniformBuffer{0};
+        FrameConstants Constants;
+        std::chrono::steady_clock::time_point Start;
+
+    }; static FrameData s_FrameData;
+
+    void Renderer::Init(const BatchRendererSpecifications& specification) 
     {
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glEnable(GL_DEPTH_TEST);
+        GLStateCache::Enable(GL_BLEND);
+        GLStateCache::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        GLStateCache::Enable(GL_DEPTH_TEST);
 
 #ifdef _DEBUG
         glEnable(GL_DEBUG_OUTPUT);
@@ -442,12 +1968,36 @@ namespace DviCore
         glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
 #endif
 
-        BatchRenderer::Init();
+        glCreateBuffers(1, &s_FrameData.UniformBuffer);
+        glNamedBufferStorage(s_FrameData.UniformBuffer, sizeof(FrameConstants), &s_FrameData.Constants, GL_DYNAMIC_STORAGE_BIT);
+        GLStateCache::BindBufferBase(GL_UNIFORM_BUFFER, FRAME_CONSTANTS_BINDING, s_FrameData.UniformBuffer);
+        s_FrameData.Start = std::chrono::steady_clock::now();
+
+        BatchRenderer::Init(specification);
     }
 
     void Renderer::Quit() 
     {
+        TextRenderer::Quit();
         BatchRenderer::Quit();
+
+        GLStateCache::DeleteBuffer(s_FrameData.UniformBuffer);
+        s_FrameData.UniformBuffer = 0;
+    }
+
+    void Renderer::UpdateFrameConstants(const glm::mat4& view, const glm::mat4& projection) 
+    {
+        std::chrono::duration<float> time = std::chrono::steady_clock::now() - s_FrameData.Start;
+        s_FrameData.Constants.View = view;
+        s_FrameData.Constants.Projection = projection;
+        s_FrameData.Constants.ViewProjection = projection * view;
+        s_FrameData.Constants.Time = time.count();
+        glNamedBufferSubData(s_FrameData.UniformBuffer, 0, sizeof(FrameConstants), &s_FrameData.Constants);
+    }
+
+    const FrameConstants& Renderer::GetFrameConstants() 
+    {
+        return s_FrameData.Constants;
     }
 
     void Renderer::Clear() 
@@ -462,6 +2012,7 @@ namespace DviCore
 
     void Renderer::SetViewport(int32_t x, int32_t y, uint32_t width, uint32_t height) 
     {
-	    glViewport(x, y, width, height);
+	    GLStateCache::Viewport(x, y, width, height);
+        s_FrameData.Constants.ViewportSize = { static_cast<float>(width), static_cast<float>(height) };
     }
 }
\ No newline at end of file
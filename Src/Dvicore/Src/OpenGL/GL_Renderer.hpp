@@ -1,6 +1,8 @@
 #pragma once 
 
 #include <array>
+#include <span>
+#include <vector>
 
 #include "GL_VertexArray.hpp"
 #include "GL_Buffers.hpp"
@@ -8,21 +10,135 @@
 #include "GL_Shader.hpp"
 #include "GL_Camera.hpp"
 #include "GL_Debug.hpp"
+#include "GL_QuadKernel.hpp"
 
 namespace DviCore 
 {
+    enum class BatchRenderMode 
+    {
+        Vertices,
+        Instanced,
+    };
+
+    enum class BatchVertexLayout 
+    {
+        Standard,
+        Compact,
+    };
+
+    enum class BatchTextureBackend 
+    {
+        Slots,
+        Arrays,
+        Bindless,
+    };
+
+    enum class BatchSubmission 
+    {
+        Direct,
+        Indirect,
+    };
+
+    // Picked per draw from the textures the batch actually used.
+    enum class BatchPipeline 
+    {
+        ColorOnly,
+        SingleTexture,
+        MultiTexture,
+    };
+
+    enum class BatchLineMode 
+    {
+        DepthTested,
+        Overlay,
+    };
+
+    struct BatchRendererSpecifications 
+    {
+        BatchRenderMode Mode{BatchRenderMode::Vertices};
+        BatchVertexLayout Layout{BatchVertexLayout::Standard};
+        BatchTextureBackend Textures{BatchTextureBackend::Bindless};
+        BatchSubmission Submission{BatchSubmission::Direct};
+        bool SortQueue{false};
+        bool Culling{false};
+        bool EdgeAntialiasing{false};
+        bool ShortIndices{true};
+        bool PersistentMapping{true};
+        uint32_t StreamingRegions{3};
+    };
+
+    struct QuadSubmission 
+    {
+        glm::mat4 Transform{1.0f};
+        glm::vec4 Color{1.0f};
+        std::shared_ptr<Texture> TexturePtr{nullptr};
+        float TilingFactor{1.0f};
+    };
+
+    // One glyph of a laid out string, its corners relative to the run's origin and its region of the font atlas.
+    struct GlyphQuad 
+    {
+        glm::vec2 Min{0.0f};
+        glm::vec2 Max{0.0f};
+        glm::vec2 TexMin{0.0f};
+        glm::vec2 TexMax{0.0f};
+    };
+
+    // Mirrors the std140 FrameConstants block every shader declares at binding FRAME_CONSTANTS_BINDING.
+    struct FrameConstants 
+    {
+        glm::mat4 View{1.0f};
+        glm::mat4 Projection{1.0f};
+        glm::mat4 ViewProjection{1.0f};
+        glm::vec2 ViewportSize{0.0f};
+        float Time{0.0f};
+        float Padding{0.0f};
+    };
+
+    static const uint32_t FRAME_CONSTANTS_BINDING = 0;
+
+    class BatchRecorder;
+
     class BatchRenderer 
     {
         private:
             BatchRenderer() = default;
             ~BatchRenderer() = default;
 
+            struct QuadStream;
+
             static void Restart();
+            static void Submit(const QuadStream& stream, size_t count);
+            static void Submit(const QuadAffine& quad, const glm::vec4& color, const glm::vec2* tex_coords, const std::shared_ptr<Texture>& texture, float tiling_factor, 
+                const glm::vec4& shape = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+            static void Write(const QuadAffine& quad, const glm::vec4& color, const glm::vec2* tex_coords, const std::shared_ptr<Texture>& texture, float tiling_factor, 
+                const glm::vec4& shape = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+            static void EmitQueue();
 
         public:
-            static void Init();
+            static void Init(const BatchRendererSpecifications& specification = BatchRendererSpecifications());
             static void Quit();
 
+            static void SetRenderMode(BatchRenderMode mode);
+            static BatchRenderMode GetRenderMode();
+            static void SetVertexLayout(BatchVertexLayout layout);
+            static BatchVertexLayout GetVertexLayout();
+            static BatchTextureBackend GetTextureBackend();
+            static void SetSubmission(BatchSubmission submission);
+            static BatchSubmission GetSubmission();
+            static void SetCulling(bool enabled);
+            static bool GetCulling();
+            static void SetQueueSorting(bool enabled);
+            static bool GetQueueSorting();
+
+            // Analytic edge anti-aliasing: instanced quads are widened by a pixel in the vertex shader and their rim fades out
+            // by its distance to the true edge, smooth edges at single-sample cost. Only instanced mode knows the whole quad in
+            // its vertex shader, the other modes draw without it. Every anti-aliased quad blends and none of them writes depth,
+            // so overlapping quads only come out right in draw order, sort the queue to draw them back-to-front.
+            static void SetEdgeAntialiasing(bool enabled);
+            static bool GetEdgeAntialiasing();
+            static void SetSortLayer(uint8_t layer);
+
             static void Begin(const Camera2D& camera);
             static void Begin(const Camera& camera, const glm::mat4& transform);
             static void End();
@@ -54,16 +170,94 @@ namespace DviCore
             static void Quad(const glm::mat4& transform, const std::shared_ptr<Texture>& texture, const glm::vec4& tint = glm::vec4(1.0f), float tiling = 1.0f);
             static void Quad(const glm::mat4& transform, const std::shared_ptr<SubTexture>& texture, const glm::vec4& tint = glm::vec4(1.0f), float tiling = 1.0f);
 
+            static void Quads(std::span<const QuadSubmission> quads);
+            static void Quads(std::span<const glm::mat4> transforms, std::span<const glm::vec4> colors, std::span<const std::shared_ptr<Texture>> textures = {});
+
+            static void Merge(const BatchRecorder& recorder);
+
+            static void Circle(const glm::mat4& transform, const glm::vec4& color, float thickness = 1.0f, float fade = 0.0f);
+            static void RoundedRect(const glm::mat4& transform, const glm::vec4& color, float radius, float thickness = 1.0f, float fade = 0.0f);
+            static void Glyphs(std::span<const GlyphQuad> glyphs, const std::shared_ptr<Texture>& atlas, const glm::mat4& transform, const glm::vec4& color);
+
+            // Single vertex sprites rasterized as GL_POINTS, size in pixels. Meant for sprites a few pixels across, a point is
+            // clipped by its center so large ones pop at the viewport edges.
+            static void Point(const glm::vec3& position, float size, const glm::vec4& color);
+            static void Point(const glm::vec3& position, float size, const std::shared_ptr<Texture>& texture, const glm::vec4& tint = glm::vec4(1.0f));
+
+            static void Line(const glm::vec3& from, const glm::vec3& to, const glm::vec4& color, BatchLineMode mode = BatchLineMode::DepthTested);
+            static void Rect(const glm::mat4& transform, const glm::vec4& color, BatchLineMode mode = BatchLineMode::DepthTested);
+
             struct RendererStatus 
             {
                 uint32_t DrawCount{0};
                 uint32_t QuadCount{0};
+                uint32_t FenceWaitCount{0};
+                float FenceWaitTime{0.0f};
+                uint64_t UploadBytes{0};
+                uint32_t FlushesAvoided{0};
+                uint32_t CulledCount{0};
+                uint32_t IndirectCommandCount{0};
+                uint32_t OpaqueCount{0};
+                uint32_t LineCount{0};
+                uint32_t LineDrawCount{0};
+                uint32_t PointCount{0};
+                uint32_t ColorOnlyDrawCount{0};
+                uint32_t SingleTextureDrawCount{0};
             };
 
             static const RendererStatus& Status();
             static void StatusReset();
     };
 
+    // A recording context that builds quads in the renderer's current format without touching GL, so every worker thread can
+    // fill its own recorder. BatchRenderer::Merge then replays recorders on the GL thread in the order they are merged.
+    // Reset() also takes the batch's culling state, reset recorders after Begin so quads outside the frustum are dropped.
+    class BatchRecorder 
+    {
+        public:
+            BatchRecorder();
+            ~BatchRecorder() = default;
+
+            void Reset();
+
+            void Quad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color);
+            void Quad(const glm::mat4& transform, const glm::vec4& color);
+            void Quad(const glm::mat4& transform, const std::shared_ptr<Texture>& texture, const glm::vec4& tint = glm::vec4(1.0f), float tiling = 1.0f);
+            void Quad(const glm::mat4& transform, const std::shared_ptr<SubTexture>& texture, const glm::vec4& tint = glm::vec4(1.0f), float tiling = 1.0f);
+
+            void Quads(std::span<const QuadSubmission> quads);
+            void Quads(std::span<const glm::mat4> transforms, std::span<const glm::vec4> colors, std::span<const std::shared_ptr<Texture>> textures = {});
+
+            uint32_t GetQuadCount() const { return m_QuadCount; }
+
+        private:
+            struct Segment 
+            {
+                size_t Offset{0};
+                uint32_t QuadCount{0};
+                uint32_t TextureCount{1};
+                std::vector<std::shared_ptr<Texture>> Textures;
+            };
+
+            void Write(const QuadAffine& quad, const glm::vec4& color, const glm::vec2* tex_coords, const std::shared_ptr<Texture>& texture, float tiling_factor);
+            bool Slot(const std::shared_ptr<Texture>& texture, uint32_t& slot);
+            void OpenSegment();
+
+        private:
+            BatchRenderMode m_Mode{BatchRenderMode::Vertices};
+            BatchVertexLayout m_Layout{BatchVertexLayout::Standard};
+            size_t m_QuadBytes{0};
+            bool m_Culling{false};
+            std::array<glm::vec4, 6> m_FrustumPlanes{};
+            uint32_t m_CulledCount{0};
+            std::vector<uint8_t> m_Data;
+            size_t m_DataSize{0};
+            std::vector<Segment> m_Segments;
+            uint32_t m_QuadCount{0};
+
+            friend class BatchRenderer;
+    };
+
     class Renderer 
     {
         private:
@@ -71,11 +265,14 @@ namespace DviCore
 			~Renderer() = default;
 
         public:
-            static void Init();
+            static void Init(const BatchRendererSpecifications& specification = BatchRendererSpecifications());
             static void Quit();
 
             static void Clear();
             static void ClearColor(const glm::vec4& color);
             static void SetViewport(int32_t x, int32_t y, uint32_t width, uint32_t height);
+
+            static void UpdateFrameConstants(const glm::mat4& view, const glm::mat4& projection);
+            static const FrameConstants& GetFrameConstants();
     };
 }
\ No newline at end of file
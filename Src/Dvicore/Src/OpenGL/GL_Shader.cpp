@@ -1,15 +1,32 @@
 #include "GL_Shader.hpp"
+#include "GL_StateCache.hpp"
 #include "Assert.hpp"
 #include "Log.hpp"
 
 namespace DviCore 
 {
     Shader::Shader(const std::string& shaderName, const std::filesystem::path& vertexShader, const std::filesystem::path& fragmentShader) 
+        : Shader(shaderName, vertexShader, fragmentShader, std::string())
+    {
+    }
+
+    Shader::Shader(const std::string& shaderName, const std::filesystem::path& vertexShader, const std::filesystem::path& fragmentShader, const std::string& defines) 
     {
         std::unordered_map<GLenum, std::string> shader_sources
         {
-            { GL_VERTEX_SHADER,   ReadFile(vertexShader)  },
-            { GL_FRAGMENT_SHADER, ReadFile(fragmentShader) }
+            { GL_VERTEX_SHADER,   InjectDefines(ReadFile(vertexShader), defines)  },
+            { GL_FRAGMENT_SHADER, InjectDefines(ReadFile(fragmentShader), defines) }
+        };
+
+        CompileShaders(shader_sources);
+        m_Name = shaderName;
+    }
+
+    Shader::Shader(const std::string& shaderName, const std::filesystem::path& computeShader) 
+    {
+        std::unordered_map<GLenum, std::string> shader_sources
+        {
+            { GL_COMPUTE_SHADER, ReadFile(computeShader) }
         };
 
         CompileShaders(shader_sources);
@@ -18,17 +35,17 @@ namespace DviCore
 
     Shader::~Shader() 
     {
-        glDeleteProgram(m_ProgramID);
+        GLStateCache::DeleteProgram(m_ProgramID);
     }
 
     void Shader::Bind() const 
     {
-        glUseProgram(m_ProgramID);
+        GLStateCache::UseProgram(m_ProgramID);
     }
 
     void Shader::Unbind() const 
     {
-        glUseProgram(0);
+        GLStateCache::UseProgram(0);
     }
 
     uint32_t Shader::GetUniformLocation(const std::string& uniform) 
@@ -131,6 +148,18 @@ namespace DviCore
         return std::string();
     }
 
+    std::string Shader::InjectDefines(const std::string& source, const std::string& defines) 
+    {
+        if(defines.empty())
+            return source;
+
+        size_t line_end = source.find('\n');
+        if(line_end == std::string::npos)
+            return source + "\n" + defines;
+
+        return source.substr(0, line_end + 1) + defines + source.substr(line_end + 1);
+    }
+
     void ShaderContainer::EmplaceShader(const std::shared_ptr<Shader>& shader) 
     {
         DVIMANA_ASSERT(m_Shaders.find(shader->GetName()) == m_Shaders.end(), "Shader already exists!");
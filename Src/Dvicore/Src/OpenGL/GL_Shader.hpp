@@ -20,6 +20,10 @@ namespace DviCore
         public:
             Shader() = default;
             Shader(const std::string& shaderName, const std::filesystem::path& vertexShader, const std::filesystem::path& fragmentShader);
+            Shader(const std::string& shaderName, const std::filesystem::path& computeShader);
+
+            // Compiles a variant of the program, the defines are inserted into both stages right after their #version line.
+            Shader(const std::string& shaderName, const std::filesystem::path& vertexShader, const std::filesystem::path& fragmentShader, const std::string& defines);
             ~Shader();
 
             void Bind() const;
@@ -41,6 +45,7 @@ namespace DviCore
         private:
             void CompileShaders(std::unordered_map<GLenum, std::string>& shaders);
             std::string ReadFile(const std::filesystem::path& path);
+            static std::string InjectDefines(const std::string& source, const std::string& defines);
 
         private:
             uint32_t m_ProgramID{0};
@@ -0,0 +1,160 @@
+#include "GL_SpriteBuffer.hpp"
+#include "GL_StateCache.hpp"
+#include "GL_QuadKernel.hpp"
+#include "Assert.hpp"
+#include "Instrument.hpp"
+
+#include <algorithm>
+
+namespace DviCore
+{
+    static const uint32_t SPRITE_BUFFER_BINDING = 2;
+
+    SpriteBuffer::SpriteBuffer(uint32_t capacity)
+    {
+        glCreateVertexArrays(1, &m_VertexArrayID);
+        m_Shader = std::make_shared<Shader>("SpriteBufferShader", "Shaders/SpriteVertex.glsl", "Shaders/SpriteFragment.glsl");
+        Grow(std::max(capacity, 1u));
+    }
+
+    SpriteBuffer::~SpriteBuffer()
+    {
+        GLStateCache::DeleteBuffer(m_BufferID);
+        GLStateCache::DeleteVertexArray(m_VertexArrayID);
+    }
+
+    uint32_t SpriteBuffer::Allocate()
+    {
+        if(!m_FreeSlots.empty())
+        {
+            uint32_t slot = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+            return slot;
+        }
+
+        if(m_SlotCount == m_Capacity)
+            Grow(m_Capacity * 2);
+
+        return m_SlotCount++;
+    }
+
+    void SpriteBuffer::Free(uint32_t slot)
+    {
+        DVIMANA_ASSERT(slot < m_SlotCount, "Sprite slot is out of range!");
+
+        // Freed slots stay in the draw range until they're reused, zero axes collapse them so they never rasterize.
+        m_Instances[slot] = SpriteInstance();
+        m_Instances[slot].AxisX = glm::vec4(0.0f);
+        m_Instances[slot].AxisY = glm::vec4(0.0f);
+        m_FreeSlots.push_back(slot);
+        MarkDirty(slot);
+    }
+
+    void SpriteBuffer::Set(uint32_t slot, const glm::mat4& transform, const glm::vec4& color)
+    {
+        DVIMANA_ASSERT(slot < m_SlotCount, "Sprite slot is out of range!");
+
+        QuadAffine quad = QuadKernel::Affine(transform);
+        SpriteInstance& instance = m_Instances[slot];
+        instance.AxisX = glm::vec4(quad.AxisX, 0.0f);
+        instance.AxisY = glm::vec4(quad.AxisY, 0.0f);
+        instance.Translation = glm::vec4(quad.Translation, 1.0f);
+        instance.Color = color;
+        MarkDirty(slot);
+    }
+
+    void SpriteBuffer::Upload()
+    {
+        if(m_DirtySlots.empty())
+            return;
+
+        DVI_PROFILE_SCOPE("SpriteBuffer::Upload");
+        std::sort(m_DirtySlots.begin(), m_DirtySlots.end());
+        m_Status.DirtySlots += static_cast<uint32_t>(m_DirtySlots.size());
+
+        // Slots a few apart go out in one range, re-sending a couple of clean slots is cheaper than another call.
+        size_t first = 0;
+        while(first < m_DirtySlots.size())
+        {
+            size_t last = first;
+            while(last + 1 < m_DirtySlots.size() && m_DirtySlots[last + 1] - m_DirtySlots[last] <= RANGE_MERGE_GAP)
+                last++;
+
+            uint32_t begin = m_DirtySlots[first];
+            uint32_t count = m_DirtySlots[last] - begin + 1;
+            GLsizeiptr size = count * sizeof(SpriteInstance);
+            glNamedBufferSubData(m_BufferID, begin * sizeof(SpriteInstance), size, m_Instances.data() + begin);
+
+            m_Status.UploadBytes += size;
+            m_Status.UploadRanges++;
+            first = last + 1;
+        }
+
+        for(uint32_t slot : m_DirtySlots)
+            m_Dirty[slot] = false;
+
+        m_DirtySlots.clear();
+    }
+
+    // The camera comes from the renderer's frame constants, update them before drawing.
+    void SpriteBuffer::Draw()
+    {
+        Upload();
+        if(SpriteCount() == 0)
+            return;
+
+        if(m_Culler != nullptr)
+        {
+            m_Culler->Cull(m_BufferID, m_SlotCount, SpriteCount());
+            m_Shader->Bind();
+            GLStateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, SPRITE_BUFFER_BINDING, m_Culler->VisibleBuffer());
+            GLStateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_Culler->CommandBuffer());
+            GLStateCache::BindVertexArray(m_VertexArrayID);
+            glDrawArraysIndirect(GL_TRIANGLES, nullptr);
+            GLStateCache::BindVertexArray(0);
+            return;
+        }
+
+        m_Shader->Bind();
+        GLStateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, SPRITE_BUFFER_BINDING, m_BufferID);
+        GLStateCache::BindVertexArray(m_VertexArrayID);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, m_SlotCount);
+        GLStateCache::BindVertexArray(0);
+    }
+
+    void SpriteBuffer::SetGPUCulling(bool enabled)
+    {
+        if(enabled == GetGPUCulling())
+            return;
+
+        m_Culler = enabled ? std::make_unique<SpriteCuller>() : nullptr;
+    }
+
+    void SpriteBuffer::MarkDirty(uint32_t slot)
+    {
+        if(m_Dirty[slot])
+            return;
+
+        m_Dirty[slot] = true;
+        m_DirtySlots.push_back(slot);
+    }
+
+    void SpriteBuffer::Grow(uint32_t capacity)
+    {
+        uint32_t buffer = 0;
+        glCreateBuffers(1, &buffer);
+        glNamedBufferStorage(buffer, capacity * sizeof(SpriteInstance), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+        // Slots already on the GPU are copied over on the GPU, dirty ones are uploaded with the next ranges anyway.
+        if(m_BufferID != 0)
+        {
+            glCopyNamedBufferSubData(m_BufferID, buffer, 0, 0, m_SlotCount * sizeof(SpriteInstance));
+            GLStateCache::DeleteBuffer(m_BufferID);
+        }
+
+        m_BufferID = buffer;
+        m_Capacity = capacity;
+        m_Instances.resize(capacity);
+        m_Dirty.resize(capacity, false);
+    }
+}
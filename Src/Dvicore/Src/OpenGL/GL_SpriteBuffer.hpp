@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "GL_Shader.hpp"
+#include "GL_SpriteCuller.hpp"
+
+namespace DviCore
+{
+    struct SpriteInstance
+    {
+        glm::vec4 AxisX{1.0f, 0.0f, 0.0f, 0.0f};
+        glm::vec4 AxisY{0.0f, 1.0f, 0.0f, 0.0f};
+        glm::vec4 Translation{0.0f, 0.0f, 0.0f, 1.0f};
+        glm::vec4 Color{1.0f};
+    };
+
+    // Retained sprites: every sprite owns a stable slot in a shader storage buffer, only slots written since the last
+    // upload are sent to the GPU, merged into contiguous ranges.
+    class SpriteBuffer
+    {
+        public:
+            static const uint32_t INITIAL_CAPACITY = 1024;
+            static const uint32_t RANGE_MERGE_GAP = 8;
+
+            SpriteBuffer(uint32_t capacity = INITIAL_CAPACITY);
+            ~SpriteBuffer();
+
+            uint32_t Allocate();
+            void Free(uint32_t slot);
+            void Set(uint32_t slot, const glm::mat4& transform, const glm::vec4& color);
+
+            void Upload();
+            void Draw();
+
+            // Culls on the GPU before every draw, see SpriteCuller.
+            void SetGPUCulling(bool enabled);
+            bool GetGPUCulling() const { return m_Culler != nullptr; }
+            const SpriteCuller* Culler() const { return m_Culler.get(); }
+
+            uint32_t Capacity() const { return m_Capacity; }
+            uint32_t SpriteCount() const { return m_SlotCount - static_cast<uint32_t>(m_FreeSlots.size()); }
+
+            struct BufferStatus
+            {
+                uint64_t UploadBytes{0};
+                uint32_t UploadRanges{0};
+                uint32_t DirtySlots{0};
+            };
+
+            const BufferStatus& Status() const { return m_Status; }
+            void StatusReset() { m_Status = BufferStatus(); }
+
+        private:
+            void MarkDirty(uint32_t slot);
+            void Grow(uint32_t capacity);
+
+        private:
+            uint32_t m_BufferID{0};
+            uint32_t m_VertexArrayID{0};
+            uint32_t m_Capacity{0};
+            uint32_t m_SlotCount{0};
+
+            std::vector<SpriteInstance> m_Instances;
+            std::vector<uint32_t> m_FreeSlots;
+            std::vector<uint32_t> m_DirtySlots;
+            std::vector<bool> m_Dirty;
+
+            std::shared_ptr<Shader> m_Shader{nullptr};
+            std::unique_ptr<SpriteCuller> m_Culler{nullptr};
+            BufferStatus m_Status;
+    };
+}
@@ -0,0 +1,110 @@
+#include "GL_SpriteCuller.hpp"
+#include "GL_SpriteBuffer.hpp"
+#include "GL_StateCache.hpp"
+#include "Instrument.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace DviCore
+{
+    static const uint32_t SOURCE_BINDING = 2;
+    static const uint32_t VISIBLE_BINDING = 3;
+    static const uint32_t COMMAND_BINDING = 4;
+
+    struct DrawArraysCommand
+    {
+        uint32_t Count{6};
+        uint32_t InstanceCount{0};
+        uint32_t First{0};
+        uint32_t BaseInstance{0};
+    };
+
+    SpriteCuller::SpriteCuller()
+    {
+        m_Shader = std::make_shared<Shader>("SpriteCullShader", "Shaders/SpriteCullCompute.glsl");
+
+        DrawArraysCommand command;
+        glCreateBuffers(1, &m_CommandBufferID);
+        glNamedBufferStorage(m_CommandBufferID, sizeof(DrawArraysCommand), &command, GL_DYNAMIC_STORAGE_BIT);
+
+        for(Query& query : m_Queries)
+        {
+            GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glCreateBuffers(1, &query.BufferID);
+            glNamedBufferStorage(query.BufferID, sizeof(uint32_t), nullptr, flags | GL_CLIENT_STORAGE_BIT);
+            query.Mapped = static_cast<const uint32_t*>(glMapNamedBufferRange(query.BufferID, 0, sizeof(uint32_t), flags));
+        }
+    }
+
+    SpriteCuller::~SpriteCuller()
+    {
+        for(Query& query : m_Queries)
+        {
+            if(query.Fence != nullptr)
+                glDeleteSync(query.Fence);
+
+            glUnmapNamedBuffer(query.BufferID);
+            GLStateCache::DeleteBuffer(query.BufferID);
+        }
+
+        GLStateCache::DeleteBuffer(m_VisibleBufferID);
+        GLStateCache::DeleteBuffer(m_CommandBufferID);
+    }
+
+    void SpriteCuller::Reserve(uint32_t capacity)
+    {
+        if(capacity <= m_Capacity)
+            return;
+
+        if(m_VisibleBufferID != 0)
+            GLStateCache::DeleteBuffer(m_VisibleBufferID);
+
+        m_Capacity = std::max(capacity, m_Capacity * 2);
+        glCreateBuffers(1, &m_VisibleBufferID);
+        glNamedBufferStorage(m_VisibleBufferID, m_Capacity * sizeof(SpriteInstance), nullptr, 0);
+    }
+
+    // Only a query whose fence has already signaled is read, one still in flight is dropped rather than waited on.
+    void SpriteCuller::ReadQuery()
+    {
+        Query& query = m_Queries[m_QueryIndex];
+        if(query.Fence == nullptr)
+            return;
+
+        GLenum result = glClientWaitSync(query.Fence, 0, 0);
+        if(result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+        {
+            m_Status.VisibleCount = *query.Mapped;
+            m_Status.CulledCount = query.SpriteCount - std::min(*query.Mapped, query.SpriteCount);
+        }
+
+        glDeleteSync(query.Fence);
+        query.Fence = nullptr;
+    }
+
+    // The camera comes from the renderer's frame constants, update them before culling.
+    void SpriteCuller::Cull(uint32_t sprite_buffer, uint32_t slot_count, uint32_t sprite_count)
+    {
+        DVI_PROFILE_SCOPE("SpriteCuller::Cull");
+        Reserve(std::max(slot_count, 1u));
+
+        DrawArraysCommand command;
+        glNamedBufferSubData(m_CommandBufferID, 0, sizeof(DrawArraysCommand), &command);
+
+        m_Shader->Bind();
+        m_Shader->Uniform("u_SpriteCount", slot_count);
+        GLStateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, SOURCE_BINDING, sprite_buffer);
+        GLStateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, VISIBLE_BINDING, m_VisibleBufferID);
+        GLStateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMAND_BINDING, m_CommandBufferID);
+        glDispatchCompute((slot_count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+        ReadQuery();
+        Query& query = m_Queries[m_QueryIndex];
+        glCopyNamedBufferSubData(m_CommandBufferID, query.BufferID, offsetof(DrawArraysCommand, InstanceCount), 0, sizeof(uint32_t));
+        query.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        query.SpriteCount = sprite_count;
+        m_QueryIndex = (m_QueryIndex + 1) % QUERY_LATENCY;
+    }
+}
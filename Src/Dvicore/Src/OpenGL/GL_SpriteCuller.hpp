@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include "GL_Shader.hpp"
+
+namespace DviCore
+{
+    // GPU culling stage for retained sprites: a compute shader tests every sprite against the frustum in the frame constants
+    // and appends the survivors to a visible buffer with an atomic counter that doubles as the instance count of an indirect
+    // draw, so the CPU never walks the sprites. Survivors land in whatever order the invocations ran, so only opaque sprites
+    // resolved by the depth test draw the same every frame. Translucent or equal-depth sprites may swap order between frames,
+    // keep translucent sprites out of the culled buffer and batch them in a fixed order instead.
+    // The visible and culled counts come back through a ring of readback buffers, QUERY_LATENCY frames late and without
+    // ever waiting on the GPU.
+    class SpriteCuller
+    {
+        public:
+            static const uint32_t WORKGROUP_SIZE = 64;
+            static const uint32_t QUERY_LATENCY = 3;
+
+            SpriteCuller();
+            ~SpriteCuller();
+
+            // Reads slot_count sprites from sprite_buffer, sprite_count of them are live, freed slots are always dropped.
+            void Cull(uint32_t sprite_buffer, uint32_t slot_count, uint32_t sprite_count);
+
+            uint32_t VisibleBuffer() const { return m_VisibleBufferID; }
+            uint32_t CommandBuffer() const { return m_CommandBufferID; }
+
+            struct CullStatus
+            {
+                uint32_t VisibleCount{0};
+                uint32_t CulledCount{0};
+            };
+
+            const CullStatus& Status() const { return m_Status; }
+
+        private:
+            void Reserve(uint32_t capacity);
+            void ReadQuery();
+
+        private:
+            struct Query
+            {
+                uint32_t BufferID{0};
+                const uint32_t* Mapped{nullptr};
+                GLsync Fence{nullptr};
+                uint32_t SpriteCount{0};
+            };
+
+            std::shared_ptr<Shader> m_Shader{nullptr};
+            uint32_t m_VisibleBufferID{0};
+            uint32_t m_CommandBufferID{0};
+            uint32_t m_Capacity{0};
+
+            std::array<Query, QUERY_LATENCY> m_Queries;
+            uint32_t m_QueryIndex{0};
+            CullStatus m_Status;
+    };
+}
@@ -0,0 +1,280 @@
+#include "GL_StateCache.hpp"
+
+#include <array>
+#include <cstddef>
+
+namespace DviCore
+{
+    static const uint32_t UNKNOWN = UINT32_MAX;
+
+    // Generic binding points that are context state, the element array binding belongs to the bound VAO and is never cached.
+    static const GLenum CACHED_BUFFER_TARGETS[] = {
+        GL_ARRAY_BUFFER,
+        GL_UNIFORM_BUFFER,
+        GL_SHADER_STORAGE_BUFFER,
+        GL_DRAW_INDIRECT_BUFFER,
+        GL_DISPATCH_INDIRECT_BUFFER,
+        GL_PIXEL_UNPACK_BUFFER,
+        GL_COPY_READ_BUFFER,
+        GL_COPY_WRITE_BUFFER,
+    };
+
+    static const uint32_t BUFFER_TARGET_COUNT = sizeof(CACHED_BUFFER_TARGETS) / sizeof(CACHED_BUFFER_TARGETS[0]);
+
+    struct StateData
+    {
+        uint32_t Program{ UNKNOWN };
+        uint32_t VertexArray{ UNKNOWN };
+        uint32_t Framebuffer{ UNKNOWN };
+        std::array<uint32_t, BUFFER_TARGET_COUNT> Buffers;
+        std::array<uint32_t, GLStateCache::MAX_BUFFER_BINDINGS> UniformBindings;
+        std::array<uint32_t, GLStateCache::MAX_BUFFER_BINDINGS> StorageBindings;
+        std::array<uint32_t, GLStateCache::MAX_TEXTURE_UNITS> Textures;
+        std::array<int32_t, 4> Viewport;
+        uint32_t Blend{ UNKNOWN };
+        uint32_t DepthTest{ UNKNOWN };
+        uint32_t DepthMask{ UNKNOWN };
+        GLenum BlendSource{ UNKNOWN }, BlendDestination{ UNKNOWN };
+
+        GLStateCache::CacheStatus Status;
+
+        StateData() { Reset(); }
+
+        void Reset()
+        {
+            Program = VertexArray = Framebuffer = UNKNOWN;
+            Buffers.fill(UNKNOWN);
+            UniformBindings.fill(UNKNOWN);
+            StorageBindings.fill(UNKNOWN);
+            Textures.fill(UNKNOWN);
+            Viewport.fill(-1);
+            Blend = DepthTest = DepthMask = UNKNOWN;
+            BlendSource = BlendDestination = UNKNOWN;
+        }
+
+    }; static StateData s_StateData;
+
+    // Returns true when the cached value already matches, otherwise records the new value and counts the call as issued.
+    template<typename T>
+    static bool Cached(T& cached, T value)
+    {
+        if(cached == value)
+        {
+            s_StateData.Status.ElidedCalls++;
+            return true;
+        }
+
+        cached = value;
+        s_StateData.Status.IssuedCalls++;
+        return false;
+    }
+
+    static uint32_t* BufferSlot(GLenum target)
+    {
+        for(uint32_t i = 0; i < BUFFER_TARGET_COUNT; i++)
+        {
+            if(CACHED_BUFFER_TARGETS[i] == target)
+                return &s_StateData.Buffers[i];
+        }
+
+        return nullptr;
+    }
+
+    static uint32_t* CapabilitySlot(GLenum capability)
+    {
+        switch(capability)
+        {
+            case GL_BLEND:      return &s_StateData.Blend;
+            case GL_DEPTH_TEST: return &s_StateData.DepthTest;
+            default:            return nullptr;
+        }
+    }
+
+    template<std::size_t N>
+    static void Forget(std::array<uint32_t, N>& bindings, uint32_t name)
+    {
+        for(uint32_t& binding : bindings)
+        {
+            if(binding == name)
+                binding = UNKNOWN;
+        }
+    }
+
+    void GLStateCache::UseProgram(uint32_t program)
+    {
+        if(!Cached(s_StateData.Program, program))
+            glUseProgram(program);
+    }
+
+    void GLStateCache::BindVertexArray(uint32_t vertex_array)
+    {
+        if(!Cached(s_StateData.VertexArray, vertex_array))
+            glBindVertexArray(vertex_array);
+    }
+
+    void GLStateCache::BindBuffer(GLenum target, uint32_t buffer)
+    {
+        uint32_t* slot = BufferSlot(target);
+        if(slot == nullptr)
+        {
+            s_StateData.Status.IssuedCalls++;
+            glBindBuffer(target, buffer);
+            return;
+        }
+
+        if(!Cached(*slot, buffer))
+            glBindBuffer(target, buffer);
+    }
+
+    void GLStateCache::BindBufferBase(GLenum target, uint32_t index, uint32_t buffer)
+    {
+        uint32_t* slot = nullptr;
+        if(target == GL_UNIFORM_BUFFER && index < MAX_BUFFER_BINDINGS)
+            slot = &s_StateData.UniformBindings[index];
+        else if(target == GL_SHADER_STORAGE_BUFFER && index < MAX_BUFFER_BINDINGS)
+            slot = &s_StateData.StorageBindings[index];
+
+        if(slot != nullptr && Cached(*slot, buffer))
+            return;
+
+        if(slot == nullptr)
+            s_StateData.Status.IssuedCalls++;
+
+        // Binding an indexed point also replaces the target's generic binding.
+        if(uint32_t* generic = BufferSlot(target))
+            *generic = buffer;
+
+        glBindBufferBase(target, index, buffer);
+    }
+
+    void GLStateCache::BindTextureUnit(uint32_t unit, uint32_t texture)
+    {
+        if(unit >= MAX_TEXTURE_UNITS)
+        {
+            s_StateData.Status.IssuedCalls++;
+            glBindTextureUnit(unit, texture);
+            return;
+        }
+
+        if(!Cached(s_StateData.Textures[unit], texture))
+            glBindTextureUnit(unit, texture);
+    }
+
+    // The core never switches the active texture unit, so classic binds land on unit 0.
+    void GLStateCache::BindTexture(GLenum target, uint32_t texture)
+    {
+        if(!Cached(s_StateData.Textures[0], texture))
+            glBindTexture(target, texture);
+    }
+
+    void GLStateCache::BindFramebuffer(uint32_t framebuffer)
+    {
+        if(!Cached(s_StateData.Framebuffer, framebuffer))
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    }
+
+    void GLStateCache::Viewport(int32_t x, int32_t y, uint32_t width, uint32_t height)
+    {
+        std::array<int32_t, 4> viewport{ x, y, static_cast<int32_t>(width), static_cast<int32_t>(height) };
+        if(!Cached(s_StateData.Viewport, viewport))
+            glViewport(x, y, width, height);
+    }
+
+    void GLStateCache::Enable(GLenum capability)
+    {
+        uint32_t* slot = CapabilitySlot(capability);
+        if(slot != nullptr && Cached(*slot, 1u))
+            return;
+
+        if(slot == nullptr)
+            s_StateData.Status.IssuedCalls++;
+
+        glEnable(capability);
+    }
+
+    void GLStateCache::Disable(GLenum capability)
+    {
+        uint32_t* slot = CapabilitySlot(capability);
+        if(slot != nullptr && Cached(*slot, 0u))
+            return;
+
+        if(slot == nullptr)
+            s_StateData.Status.IssuedCalls++;
+
+        glDisable(capability);
+    }
+
+    void GLStateCache::DepthMask(bool enabled)
+    {
+        if(!Cached(s_StateData.DepthMask, enabled ? 1u : 0u))
+            glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    }
+
+    void GLStateCache::BlendFunc(GLenum source, GLenum destination)
+    {
+        if(s_StateData.BlendSource == source && s_StateData.BlendDestination == destination)
+        {
+            s_StateData.Status.ElidedCalls++;
+            return;
+        }
+
+        s_StateData.BlendSource = source;
+        s_StateData.BlendDestination = destination;
+        s_StateData.Status.IssuedCalls++;
+        glBlendFunc(source, destination);
+    }
+
+    // Deleting a bound object changes what GL has bound, those entries become unknown so the next bind is always issued.
+    void GLStateCache::DeleteProgram(uint32_t program)
+    {
+        if(s_StateData.Program == program)
+            s_StateData.Program = UNKNOWN;
+
+        glDeleteProgram(program);
+    }
+
+    void GLStateCache::DeleteVertexArray(uint32_t vertex_array)
+    {
+        if(s_StateData.VertexArray == vertex_array)
+            s_StateData.VertexArray = UNKNOWN;
+
+        glDeleteVertexArrays(1, &vertex_array);
+    }
+
+    void GLStateCache::DeleteBuffer(uint32_t buffer)
+    {
+        Forget(s_StateData.Buffers, buffer);
+        Forget(s_StateData.UniformBindings, buffer);
+        Forget(s_StateData.StorageBindings, buffer);
+        glDeleteBuffers(1, &buffer);
+    }
+
+    void GLStateCache::DeleteTexture(uint32_t texture)
+    {
+        Forget(s_StateData.Textures, texture);
+        glDeleteTextures(1, &texture);
+    }
+
+    void GLStateCache::DeleteFramebuffer(uint32_t framebuffer)
+    {
+        if(s_StateData.Framebuffer == framebuffer)
+            s_StateData.Framebuffer = UNKNOWN;
+
+        glDeleteFramebuffers(1, &framebuffer);
+    }
+
+    void GLStateCache::Invalidate()
+    {
+        s_StateData.Reset();
+    }
+
+    const GLStateCache::CacheStatus& GLStateCache::Status()
+    {
+        return s_StateData.Status;
+    }
+
+    void GLStateCache::StatusReset()
+    {
+        s_StateData.Status = CacheStatus();
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <glad/glad.h>
+
+namespace DviCore
+{
+    // Mirrors the GL state the renderer core touches and skips calls that wouldn't change it. Binds, state toggles and
+    // deletes in the core all go through here, code that changes GL state behind its back has to call Invalidate().
+    class GLStateCache
+    {
+        private:
+            GLStateCache() = default;
+            ~GLStateCache() = default;
+
+        public:
+            static const uint32_t MAX_TEXTURE_UNITS = 32;
+            static const uint32_t MAX_BUFFER_BINDINGS = 8;
+
+            static void UseProgram(uint32_t program);
+            static void BindVertexArray(uint32_t vertex_array);
+            static void BindBuffer(GLenum target, uint32_t buffer);
+            static void BindBufferBase(GLenum target, uint32_t index, uint32_t buffer);
+            static void BindTextureUnit(uint32_t unit, uint32_t texture);
+            static void BindTexture(GLenum target, uint32_t texture);
+            static void BindFramebuffer(uint32_t framebuffer);
+            static void Viewport(int32_t x, int32_t y, uint32_t width, uint32_t height);
+            static void Enable(GLenum capability);
+            static void Disable(GLenum capability);
+            static void DepthMask(bool enabled);
+            static void BlendFunc(GLenum source, GLenum destination);
+
+            static void DeleteProgram(uint32_t program);
+            static void DeleteVertexArray(uint32_t vertex_array);
+            static void DeleteBuffer(uint32_t buffer);
+            static void DeleteTexture(uint32_t texture);
+            static void DeleteFramebuffer(uint32_t framebuffer);
+
+            static void Invalidate();
+
+            struct CacheStatus
+            {
+                uint32_t IssuedCalls{0};
+                uint32_t ElidedCalls{0};
+            };
+
+            static const CacheStatus& Status();
+            static void StatusReset();
+    };
+}
@@ -0,0 +1,261 @@
+#include "GL_TextRenderer.hpp"
+#include "Assert.hpp"
+#include "Log.hpp"
+#include "Instrument.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+// ImGui ships stb_truetype, compiled privately here so the font code doesn't depend on ImGui's internals.
+#define STB_TRUETYPE_IMPLEMENTATION
+#define STBTT_STATIC
+#include <ImGuiDocking/imstb_truetype.h>
+
+namespace DviCore
+{
+    static const char* DEFAULT_FONT_PATH = "Editor/Fonts/OpenSans/OpenSans-Regular.ttf";
+    static const uint8_t SDF_ON_EDGE = 128;
+
+    Font::Font(const std::filesystem::path& path, const FontSpecifications& specification)
+        : m_Specification(specification)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if(!file)
+        {
+            DVI_CORE_ERROR("{0} Font file does not exist!", path.string());
+            return;
+        }
+
+        std::vector<uint8_t> font_data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        stbtt_fontinfo info;
+        if(!stbtt_InitFont(&info, font_data.data(), stbtt_GetFontOffsetForIndex(font_data.data(), 0)))
+        {
+            DVI_CORE_ERROR("Failed to load font file -> {0}!", path.string());
+            return;
+        }
+
+        DVI_PROFILE_SCOPE("Font::Rasterize");
+        float pixel_size = m_Specification.PixelSize;
+        float scale = stbtt_ScaleForPixelHeight(&info, pixel_size);
+
+        int32_t ascent = 0, descent = 0, line_gap = 0;
+        stbtt_GetFontVMetrics(&info, &ascent, &descent, &line_gap);
+        m_LineHeight = (ascent - descent + line_gap) * scale / pixel_size;
+
+        struct Bitmap
+        {
+            uint8_t* Pixels{nullptr};
+            int32_t Width{0}, Height{0}, X{0}, Y{0};
+        };
+
+        // Every glyph is rasterized once, shelves packed left to right, the atlas height rounds up to a power of two.
+        std::vector<Bitmap> bitmaps(GLYPH_COUNT);
+        m_Glyphs.resize(GLYPH_COUNT);
+        int32_t atlas_width = m_Specification.AtlasWidth;
+        int32_t shelf_x = 0, shelf_y = 0, shelf_height = 0;
+        float distance_scale = static_cast<float>(SDF_ON_EDGE) / m_Specification.Padding;
+
+        for(uint32_t i = 0; i < GLYPH_COUNT; i++)
+        {
+            uint32_t codepoint = FIRST_CODEPOINT + i;
+            int32_t advance = 0, bearing = 0;
+            stbtt_GetCodepointHMetrics(&info, codepoint, &advance, &bearing);
+            m_Glyphs[i].Advance = advance * scale / pixel_size;
+
+            Bitmap& bitmap = bitmaps[i];
+            int32_t x_offset = 0, y_offset = 0;
+            bitmap.Pixels = stbtt_GetCodepointSDF(&info, scale, codepoint, m_Specification.Padding, SDF_ON_EDGE, distance_scale, &bitmap.Width, &bitmap.Height, &x_offset, &y_offset);
+            if(bitmap.Pixels == nullptr)
+                continue;
+
+            if(shelf_x + bitmap.Width > atlas_width)
+            {
+                shelf_x = 0;
+                shelf_y += shelf_height;
+                shelf_height = 0;
+            }
+
+            bitmap.X = shelf_x;
+            bitmap.Y = shelf_y;
+            shelf_x += bitmap.Width;
+            shelf_height = std::max(shelf_height, bitmap.Height);
+
+            Glyph& glyph = m_Glyphs[i];
+            glyph.Min = glm::vec2(x_offset, -(y_offset + bitmap.Height)) / pixel_size;
+            glyph.Max = glm::vec2(x_offset + bitmap.Width, -y_offset) / pixel_size;
+            glyph.Visible = true;
+        }
+
+        int32_t atlas_height = 1;
+        while(atlas_height < shelf_y + shelf_height)
+            atlas_height *= 2;
+
+        // White texels carry the distance in their alpha, so the atlas also draws as a plain texture.
+        std::vector<uint8_t> pixels(static_cast<size_t>(atlas_width) * atlas_height * 4, 255);
+        for(size_t i = 3; i < pixels.size(); i += 4)
+            pixels[i] = 0;
+
+        for(uint32_t i = 0; i < GLYPH_COUNT; i++)
+        {
+            Bitmap& bitmap = bitmaps[i];
+            if(bitmap.Pixels == nullptr)
+                continue;
+
+            for(int32_t row = 0; row < bitmap.Height; row++)
+            {
+                for(int32_t column = 0; column < bitmap.Width; column++)
+                    pixels[((static_cast<size_t>(bitmap.Y) + row) * atlas_width + bitmap.X + column) * 4 + 3] = bitmap.Pixels[row * bitmap.Width + column];
+            }
+
+            Glyph& glyph = m_Glyphs[i];
+            glyph.TexMin = glm::vec2(bitmap.X, bitmap.Y) / glm::vec2(atlas_width, atlas_height);
+            glyph.TexMax = glm::vec2(bitmap.X + bitmap.Width, bitmap.Y + bitmap.Height) / glm::vec2(atlas_width, atlas_height);
+            stbtt_FreeSDF(bitmap.Pixels, nullptr);
+        }
+
+        m_Kerning.resize(GLYPH_COUNT * GLYPH_COUNT, 0.0f);
+        if(info.kern != 0 || info.gpos != 0)
+        {
+            for(uint32_t first = 0; first < GLYPH_COUNT; first++)
+            {
+                for(uint32_t second = 0; second < GLYPH_COUNT; second++)
+                    m_Kerning[first * GLYPH_COUNT + second] = stbtt_GetCodepointKernAdvance(&info, FIRST_CODEPOINT + first, FIRST_CODEPOINT + second) * scale / pixel_size;
+            }
+        }
+
+        m_Atlas = std::make_shared<Texture>(atlas_width, atlas_height);
+        m_Atlas->SetData(pixels.data(), 0, 0, atlas_width, atlas_height);
+        m_Atlas->SetSampling({ GL_LINEAR, GL_LINEAR, GL_CLAMP_TO_EDGE });
+    }
+
+    uint32_t Font::GlyphIndex(uint32_t codepoint)
+    {
+        if(codepoint < FIRST_CODEPOINT || codepoint > LAST_CODEPOINT)
+            codepoint = FALLBACK_CODEPOINT;
+
+        return codepoint - FIRST_CODEPOINT;
+    }
+
+    const Font::Glyph& Font::GetGlyph(uint32_t codepoint) const
+    {
+        return m_Glyphs[GlyphIndex(codepoint)];
+    }
+
+    float Font::Kerning(uint32_t first, uint32_t second) const
+    {
+        return m_Kerning[GlyphIndex(first) * GLYPH_COUNT + GlyphIndex(second)];
+    }
+
+    struct TextData
+    {
+        std::shared_ptr<Font> DefaultFont{nullptr};
+        std::unordered_map<const Font*, std::unordered_map<std::string, TextRun>> Runs;
+        uint32_t CachedRuns{0};
+
+        TextRenderer::TextStatus Status;
+
+    }; static TextData s_TextData;
+
+    void TextRenderer::Quit()
+    {
+        ClearCache();
+        s_TextData.DefaultFont = nullptr;
+    }
+
+    std::shared_ptr<Font> TextRenderer::DefaultFont()
+    {
+        if(s_TextData.DefaultFont == nullptr)
+            s_TextData.DefaultFont = std::make_shared<Font>(DEFAULT_FONT_PATH);
+
+        return s_TextData.DefaultFont;
+    }
+
+    // Bytes outside printable ASCII fall back to the font's fallback glyph, newlines start the next line below.
+    TextRun TextRenderer::Layout(const Font& font, const std::string& text)
+    {
+        TextRun run;
+        run.Glyphs.reserve(text.size());
+        s_TextData.Status.RunsShaped++;
+
+        glm::vec2 pen{0.0f};
+        uint32_t previous = 0;
+        for(char character : text)
+        {
+            uint32_t codepoint = static_cast<uint8_t>(character);
+            if(codepoint == '\n')
+            {
+                run.Size.x = std::max(run.Size.x, pen.x);
+                pen = { 0.0f, pen.y - font.LineHeight() };
+                previous = 0;
+                continue;
+            }
+
+            if(previous != 0)
+                pen.x += font.Kerning(previous, codepoint);
+
+            const Font::Glyph& glyph = font.GetGlyph(codepoint);
+            if(glyph.Visible)
+                run.Glyphs.push_back({ pen + glyph.Min, pen + glyph.Max, glyph.TexMin, glyph.TexMax });
+
+            pen.x += glyph.Advance;
+            previous = codepoint;
+        }
+
+        run.Size = { std::max(run.Size.x, pen.x), font.LineHeight() - pen.y };
+        return run;
+    }
+
+    // Runs are cached per font and string, strings that change every frame should be laid out with Layout instead. The cache
+    // starts over once it holds MAX_CACHED_RUNS runs.
+    const TextRun& TextRenderer::Shape(const std::shared_ptr<Font>& font, const std::string& text)
+    {
+        std::unordered_map<std::string, TextRun>& runs = s_TextData.Runs[font.get()];
+        auto found = runs.find(text);
+        if(found != runs.end())
+            return found->second;
+
+        if(s_TextData.CachedRuns >= MAX_CACHED_RUNS)
+        {
+            ClearCache();
+            return Shape(font, text);
+        }
+
+        s_TextData.CachedRuns++;
+        s_TextData.Status.CachedRuns = s_TextData.CachedRuns;
+        return runs.emplace(text, Layout(*font, text)).first->second;
+    }
+
+    void TextRenderer::ClearCache()
+    {
+        s_TextData.Runs.clear();
+        s_TextData.CachedRuns = 0;
+        s_TextData.Status.CachedRuns = 0;
+    }
+
+    void TextRenderer::Text(const std::string& text, const glm::mat4& transform, const glm::vec4& color, const std::shared_ptr<Font>& font)
+    {
+        const std::shared_ptr<Font>& used_font = font != nullptr ? font : DefaultFont();
+        if(!used_font->Loaded())
+            return;
+
+        Text(Shape(used_font, text), used_font, transform, color);
+    }
+
+    void TextRenderer::Text(const TextRun& run, const std::shared_ptr<Font>& font, const glm::mat4& transform, const glm::vec4& color)
+    {
+        DVIMANA_ASSERT(font != nullptr && font->Loaded(), "Text needs a loaded font!");
+        BatchRenderer::Glyphs(run.Glyphs, font->Atlas(), transform, color);
+        s_TextData.Status.GlyphCount += static_cast<uint32_t>(run.Glyphs.size());
+    }
+
+    const TextRenderer::TextStatus& TextRenderer::Status()
+    {
+        return s_TextData.Status;
+    }
+
+    void TextRenderer::StatusReset()
+    {
+        s_TextData.Status.GlyphCount = 0;
+        s_TextData.Status.RunsShaped = 0;
+    }
+}
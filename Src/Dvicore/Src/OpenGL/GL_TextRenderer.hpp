@@ -0,0 +1,97 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "GL_Renderer.hpp"
+
+namespace DviCore
+{
+    struct FontSpecifications
+    {
+        float PixelSize{48.0f};
+        int32_t Padding{6};
+        int32_t AtlasWidth{512};
+    };
+
+    // A font rasterized once into a signed distance field atlas: the alpha of every texel holds the distance to the glyph edge,
+    // 0.5 on the edge, so glyphs stay sharp at any scale. Glyph geometry is in line units, one unit is the font's line height.
+    class Font
+    {
+        public:
+            static const uint32_t FIRST_CODEPOINT = 32;
+            static const uint32_t LAST_CODEPOINT = 126;
+            static const uint32_t FALLBACK_CODEPOINT = '?';
+
+            struct Glyph
+            {
+                glm::vec2 Min{0.0f};
+                glm::vec2 Max{0.0f};
+                glm::vec2 TexMin{0.0f};
+                glm::vec2 TexMax{0.0f};
+                float Advance{0.0f};
+                bool Visible{false};
+            };
+
+            Font(const std::filesystem::path& path, const FontSpecifications& specification = FontSpecifications());
+            ~Font() = default;
+
+            const Glyph& GetGlyph(uint32_t codepoint) const;
+            float Kerning(uint32_t first, uint32_t second) const;
+            float LineHeight() const { return m_LineHeight; }
+            const std::shared_ptr<Texture>& Atlas() const { return m_Atlas; }
+            bool Loaded() const { return m_Atlas != nullptr; }
+
+        private:
+            static uint32_t GlyphIndex(uint32_t codepoint);
+
+        private:
+            static const uint32_t GLYPH_COUNT = LAST_CODEPOINT - FIRST_CODEPOINT + 1;
+
+            FontSpecifications m_Specification;
+            std::vector<Glyph> m_Glyphs;
+            std::vector<float> m_Kerning;
+            float m_LineHeight{1.0f};
+            std::shared_ptr<Texture> m_Atlas{nullptr};
+    };
+
+    // A laid out string, glyph quads relative to the run's origin on the first baseline.
+    struct TextRun
+    {
+        std::vector<GlyphQuad> Glyphs;
+        glm::vec2 Size{0.0f};
+    };
+
+    class TextRenderer
+    {
+        private:
+            TextRenderer() = default;
+            ~TextRenderer() = default;
+
+        public:
+            static const uint32_t MAX_CACHED_RUNS = 4096;
+
+            static void Quit();
+
+            static std::shared_ptr<Font> DefaultFont();
+            static TextRun Layout(const Font& font, const std::string& text);
+            static const TextRun& Shape(const std::shared_ptr<Font>& font, const std::string& text);
+            static void ClearCache();
+
+            static void Text(const std::string& text, const glm::mat4& transform, const glm::vec4& color, const std::shared_ptr<Font>& font = nullptr);
+            static void Text(const TextRun& run, const std::shared_ptr<Font>& font, const glm::mat4& transform, const glm::vec4& color);
+
+            struct TextStatus
+            {
+                uint32_t GlyphCount{0};
+                uint32_t RunsShaped{0};
+                uint32_t CachedRuns{0};
+            };
+
+            static const TextStatus& Status();
+            static void StatusReset();
+    };
+}
@@ -1,8 +1,24 @@
 #include "GL_Texture.hpp"
+#include "GL_StateCache.hpp"
 #include "Log.hpp"
+#include "Assert.hpp"
+
+#include <algorithm>
+#include <climits>
 
 namespace DviCore {
 
+    static bool HasTranslucentTexels(const uint8_t* pixels, size_t count) 
+    {
+        for(size_t i = 0; i < count; i++) 
+        {
+            if(pixels[i * 4 + 3] != 255)
+                return true;
+        }
+
+        return false;
+    }
+
     Texture::Texture(uint32_t width, uint32_t height) 
     {
         m_Width = width;
@@ -16,7 +32,7 @@ namespace DviCore {
         m_DataFormat = GL_RGBA;
 
         glCreateTextures(GL_TEXTURE_2D, 1, &m_TextureID);
-        glBindTexture(GL_TEXTURE_2D, m_TextureID);
+        GLStateCache::BindTexture(GL_TEXTURE_2D, m_TextureID);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -48,6 +64,7 @@ namespace DviCore {
         {
 			m_InternalFormat    = GL_RGBA8;
 			m_DataFormat        = GL_RGBA;
+            m_Opaque            = !HasTranslucentTexels(static_cast<const uint8_t*>(m_Data), static_cast<size_t>(m_Width) * m_Height);
 		} 
         else
         {
@@ -56,7 +73,7 @@ namespace DviCore {
 		}
 
         glCreateTextures(GL_TEXTURE_2D, 1, &m_TextureID);
-		glBindTexture(GL_TEXTURE_2D, m_TextureID);
+		GLStateCache::BindTexture(GL_TEXTURE_2D, m_TextureID);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -66,23 +83,96 @@ namespace DviCore {
 		m_FromImageFile = true;
     }
 
+    Texture::Texture(uint32_t width, uint32_t height, GLenum internal_format) 
+    {
+        m_Width = width;
+        m_Height = height;
+        m_Channels = 4;
+        m_InternalFormat = internal_format;
+        m_DataFormat = GL_RGBA;
+        m_Opaque = false;
+
+        int32_t levels = 1;
+        for(int32_t size = std::max(m_Width, m_Height); size > 1; size >>= 1)
+            levels++;
+
+        glCreateTextures(GL_TEXTURE_2D, 1, &m_TextureID);
+        SetSampling({ GL_LINEAR, GL_NEAREST, GL_CLAMP_TO_EDGE });
+        glTextureStorage2D(m_TextureID, levels, m_InternalFormat, m_Width, m_Height);
+    }
+
     Texture::~Texture() 
     {
         (m_FromImageFile) ? stbi_image_free(m_Data) : delete[] m_Data;
-        glDeleteTextures(1, &m_TextureID);
+        if(m_BindlessHandle != 0)
+            glMakeTextureHandleNonResidentARB(m_BindlessHandle);
+
+        GLStateCache::DeleteTexture(m_TextureID);
+    }
+
+    uint64_t Texture::BindlessHandle() const 
+    {
+        if(m_BindlessHandle == 0 && GLAD_GL_ARB_bindless_texture) 
+        {
+            m_BindlessHandle = glGetTextureHandleARB(m_TextureID);
+            glMakeTextureHandleResidentARB(m_BindlessHandle);
+        }
+
+        return m_BindlessHandle;
     }
 
     void Texture::Bind(uint32_t slot) const 
     {
-        glBindTextureUnit(slot, m_TextureID);
+        GLStateCache::BindTextureUnit(slot, m_TextureID);
     }
 
     void Texture::Unbind() const 
     {
-        glBindTexture(GL_TEXTURE_2D, 0);
+        GLStateCache::BindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    void Texture::SetData(const void* data, int32_t x, int32_t y, int32_t width, int32_t height) 
+    {
+        DVIMANA_ASSERT(!m_FromImageFile && m_Channels == 4, "Only RGBA textures created in memory can be updated!");
+        DVIMANA_ASSERT(x >= 0 && y >= 0 && x + width <= m_Width && y + height <= m_Height, "Texture update is out of bounds!");
+
+        const uint8_t* source = static_cast<const uint8_t*>(data);
+        uint8_t* destination = static_cast<uint8_t*>(m_Data);
+        for(int32_t row = 0; row < height; row++)
+            std::memcpy(destination + ((y + row) * m_Width + x) * 4, source + row * width * 4, width * 4);
+
+        // Stays conservative, a texture that ever received translucent texels is treated as translucent from then on.
+        if(m_Opaque && HasTranslucentTexels(source, static_cast<size_t>(width) * height))
+            m_Opaque = false;
+
+        glTextureSubImage2D(m_TextureID, 0, x, y, width, height, m_DataFormat, GL_UNSIGNED_BYTE, data);
+        m_Revision++;
+    }
+
+    // Copies of the texture, its layer in a texture array, are refreshed on their next use.
+    void Texture::Rendered() 
+    {
+        DVIMANA_ASSERT(m_Data == nullptr, "Only render targets are drawn into!");
+        glGenerateTextureMipmap(m_TextureID);
+        m_Revision++;
+    }
+
+    void Texture::SetSampling(const TextureSampling& sampling) 
+    {
+        DVIMANA_ASSERT(m_BindlessHandle == 0, "A texture's sampling can't change once it has a bindless handle!");
+        m_Sampling = sampling;
+        glTextureParameteri(m_TextureID, GL_TEXTURE_MIN_FILTER, sampling.MinFilter);
+        glTextureParameteri(m_TextureID, GL_TEXTURE_MAG_FILTER, sampling.MagFilter);
+        glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_S, sampling.Wrap);
+        glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_T, sampling.Wrap);
     }
 
     SubTexture::SubTexture(const std::shared_ptr<Texture>& texture, const glm::vec2& min, const glm::vec2& max) 
+    {
+        SetRegion(texture, min, max);
+    }
+
+    void SubTexture::SetRegion(const std::shared_ptr<Texture>& texture, const glm::vec2& min, const glm::vec2& max) 
     {
     	m_Texture = texture;
         m_TexCoords[0] = { min.x, min.y };
@@ -99,4 +189,251 @@ namespace DviCore {
         glm::vec2 max = { ((coords.x + spriteSize.x) * cellSize.x) / textureWidth, ((coords.y + spriteSize.y) * cellSize.y) / textureHeight };
         return std::make_shared<SubTexture>(texture, min, max);
     }
+
+    TextureAtlas::TextureAtlas(const TextureAtlasSpecifications& specification) :
+        m_Specification(specification)
+    {
+    }
+
+    std::shared_ptr<SubTexture> TextureAtlas::Add(const std::string& name, const std::filesystem::path& path, bool flip) 
+    {
+        if(!std::filesystem::exists(path))
+        {
+            DVI_CORE_ERROR("{0} Texture file does not exist!", path.string());
+            return nullptr;
+        }
+
+        int32_t width = 0, height = 0, channels = 0;
+        stbi_set_flip_vertically_on_load(flip);
+        uint8_t* pixels = stbi_load(path.string().c_str(), &width, &height, &channels, 4);
+        if(!pixels) 
+        {
+            DVI_CORE_ERROR("Failed to load texture file -> {0}!", path.string());
+            return nullptr;
+        }
+
+        std::shared_ptr<SubTexture> region = Add(name, pixels, width, height);
+        stbi_image_free(pixels);
+        return region;
+    }
+
+    std::shared_ptr<SubTexture> TextureAtlas::Add(const std::string& name, const uint8_t* pixels, int32_t width, int32_t height) 
+    {
+        auto found = m_Entries.find(name);
+        if(found != m_Entries.end())
+            return found->second.Region;
+
+        int32_t padding = m_Specification.Padding;
+        if(width + padding * 2 > m_Specification.MaxPageSize || height + padding * 2 > m_Specification.MaxPageSize) 
+        {
+            DVI_CORE_ERROR("{0} is too large for the texture atlas!", name);
+            return nullptr;
+        }
+
+        // The padding repeats the image's edge pixels so linear filtering never bleeds neighbours into it.
+        Entry entry;
+        entry.Width = width + padding * 2;
+        entry.Height = height + padding * 2;
+        entry.Pixels.resize(static_cast<size_t>(entry.Width) * entry.Height * 4);
+        for(int32_t y = 0; y < entry.Height; y++) 
+        {
+            int32_t source_y = std::clamp(y - padding, 0, height - 1);
+            for(int32_t x = 0; x < entry.Width; x++) 
+            {
+                int32_t source_x = std::clamp(x - padding, 0, width - 1);
+                std::memcpy(&entry.Pixels[(static_cast<size_t>(y) * entry.Width + x) * 4], pixels + (static_cast<size_t>(source_y) * width + source_x) * 4, 4);
+            }
+        }
+
+        if(!Place(entry)) 
+        {
+            Repack();
+            if(!Place(entry)) 
+            {
+                DVI_CORE_ERROR("Texture atlas is full, {0} couldn't be added!", name);
+                return nullptr;
+            }
+        }
+
+        entry.Region = std::make_shared<SubTexture>(nullptr, glm::vec2(0.0f), glm::vec2(1.0f));
+        Upload(entry);
+        UpdateRegion(entry);
+        return m_Entries.emplace(name, std::move(entry)).first->second.Region;
+    }
+
+    std::shared_ptr<SubTexture> TextureAtlas::Get(const std::string& name) const 
+    {
+        auto found = m_Entries.find(name);
+        return found != m_Entries.end() ? found->second.Region : nullptr;
+    }
+
+    void TextureAtlas::Remove(const std::string& name) 
+    {
+        m_Entries.erase(name);
+    }
+
+    void TextureAtlas::Repack() 
+    {
+        std::vector<Entry*> entries;
+        entries.reserve(m_Entries.size());
+        for(auto& [name, entry] : m_Entries) 
+        {
+            entry.PageIndex = UINT32_MAX;
+            entries.push_back(&entry);
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const Entry* a, const Entry* b)
+        {
+            return a->Height != b->Height ? a->Height > b->Height : a->Width > b->Width;
+        });
+
+        m_Pages.clear();
+        for(Entry* entry : entries) 
+        {
+            bool placed = Place(*entry);
+            DVIMANA_ASSERT(placed, "Texture atlas lost an image while repacking!");
+            Upload(*entry);
+            UpdateRegion(*entry);
+        }
+    }
+
+    bool TextureAtlas::Place(Entry& entry) 
+    {
+        for(uint32_t i = 0; i < m_Pages.size(); i++) 
+        {
+            bool inserted = Insert(m_Pages[i], entry.Width, entry.Height, entry.X, entry.Y);
+            while(!inserted && m_Pages[i].Size < m_Specification.MaxPageSize) 
+            {
+                Grow(i);
+                inserted = Insert(m_Pages[i], entry.Width, entry.Height, entry.X, entry.Y);
+            }
+
+            if(inserted) 
+            {
+                entry.PageIndex = i;
+                return true;
+            }
+        }
+
+        if(m_Pages.size() >= m_Specification.MaxPages)
+            return false;
+
+        int32_t size = m_Specification.InitialPageSize;
+        while(size < entry.Width || size < entry.Height)
+            size *= 2;
+
+        m_Pages.push_back(CreatePage(std::min(size, m_Specification.MaxPageSize)));
+        entry.PageIndex = static_cast<uint32_t>(m_Pages.size() - 1);
+        return Insert(m_Pages.back(), entry.Width, entry.Height, entry.X, entry.Y);
+    }
+
+    // Bottom-left skyline packing: the image goes where its bottom edge ends up lowest, ties prefer the narrower segment.
+    bool TextureAtlas::Insert(AtlasPage& page, int32_t width, int32_t height, int32_t& x, int32_t& y) 
+    {
+        x = -1;
+        y = -1;
+
+        size_t best_index = page.Skyline.size();
+        int32_t best_y = INT_MAX, best_width = INT_MAX;
+        for(size_t i = 0; i < page.Skyline.size(); i++) 
+        {
+            if(page.Skyline[i].X + width > page.Size)
+                break;
+
+            int32_t top = 0;
+            for(size_t j = i, remaining = width; remaining > 0; j++) 
+            {
+                top = std::max(top, page.Skyline[j].Y);
+                remaining -= std::min<size_t>(remaining, page.Skyline[j].Width);
+            }
+
+            if(top + height > page.Size)
+                continue;
+
+            if(top < best_y || (top == best_y && page.Skyline[i].Width < best_width)) 
+            {
+                best_index = i;
+                best_y = top;
+                best_width = page.Skyline[i].Width;
+            }
+        }
+
+        if(best_index == page.Skyline.size())
+            return false;
+
+        x = page.Skyline[best_index].X;
+        y = best_y;
+        page.Skyline.insert(page.Skyline.begin() + best_index, { x, y + height, width });
+
+        for(size_t i = best_index + 1; i < page.Skyline.size();) 
+        {
+            int32_t covered = page.Skyline[i - 1].X + page.Skyline[i - 1].Width - page.Skyline[i].X;
+            if(covered <= 0)
+                break;
+
+            page.Skyline[i].X += covered;
+            page.Skyline[i].Width -= covered;
+            if(page.Skyline[i].Width > 0)
+                break;
+
+            page.Skyline.erase(page.Skyline.begin() + i);
+        }
+
+        for(size_t i = 0; i + 1 < page.Skyline.size();) 
+        {
+            if(page.Skyline[i].Y == page.Skyline[i + 1].Y) 
+            {
+                page.Skyline[i].Width += page.Skyline[i + 1].Width;
+                page.Skyline.erase(page.Skyline.begin() + i + 1);
+            }
+            else 
+            {
+                i++;
+            }
+        }
+
+        return true;
+    }
+
+    // Doubling a page keeps every placement valid, the skyline only gains the new columns on the right.
+    void TextureAtlas::Grow(uint32_t page_index) 
+    {
+        AtlasPage& page = m_Pages[page_index];
+        AtlasPage grown = CreatePage(std::min(page.Size * 2, m_Specification.MaxPageSize));
+        grown.PageTexture->SetData(page.PageTexture->TextureData(), 0, 0, page.Size, page.Size);
+        grown.Skyline = page.Skyline;
+        grown.Skyline.push_back({ page.Size, 0, grown.Size - page.Size });
+        page = std::move(grown);
+
+        for(auto& [name, entry] : m_Entries) 
+        {
+            if(entry.PageIndex == page_index)
+                UpdateRegion(entry);
+        }
+    }
+
+    void TextureAtlas::Upload(const Entry& entry) 
+    {
+        m_Pages[entry.PageIndex].PageTexture->SetData(entry.Pixels.data(), entry.X, entry.Y, entry.Width, entry.Height);
+    }
+
+    void TextureAtlas::UpdateRegion(Entry& entry) 
+    {
+        const AtlasPage& page = m_Pages[entry.PageIndex];
+        float size = static_cast<float>(page.Size);
+        int32_t padding = m_Specification.Padding;
+
+        glm::vec2 min = { (entry.X + padding) / size, (entry.Y + padding) / size };
+        glm::vec2 max = { (entry.X + entry.Width - padding) / size, (entry.Y + entry.Height - padding) / size };
+        entry.Region->SetRegion(page.PageTexture, min, max);
+    }
+
+    TextureAtlas::AtlasPage TextureAtlas::CreatePage(int32_t size) const 
+    {
+        AtlasPage page;
+        page.PageTexture = std::make_shared<Texture>(size, size);
+        page.Size = size;
+        page.Skyline.push_back({ 0, 0, size });
+        return page;
+    }
 }
\ No newline at end of file
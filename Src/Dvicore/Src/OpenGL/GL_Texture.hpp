@@ -1,6 +1,10 @@
 #pragma once 
 
 #include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/glm.hpp>
@@ -14,31 +18,56 @@
 
 namespace DviCore
 {
+    struct TextureSampling 
+    {
+        GLenum MinFilter{GL_LINEAR};
+        GLenum MagFilter{GL_NEAREST};
+        GLenum Wrap{GL_REPEAT};
+
+        bool operator==(const TextureSampling& other) const { return MinFilter == other.MinFilter && MagFilter == other.MagFilter && Wrap == other.Wrap; }
+    };
+
     class Texture 
     {
         public:
             Texture(uint32_t width, uint32_t height);
             Texture(const std::filesystem::path& path, bool flip = true);
+
+            // A render target: a full mip chain of GPU-only storage, translucent, call Rendered() after drawing into it.
+            Texture(uint32_t width, uint32_t height, GLenum internal_format);
             ~Texture();
 
             void Bind(uint32_t slot = 0) const;
             void Unbind() const;
+            void SetData(const void* data, int32_t x, int32_t y, int32_t width, int32_t height);
+            void Rendered();
+
+            // Set before the texture is first drawn, texture arrays and bindless handles take the sampling state over then.
+            void SetSampling(const TextureSampling& sampling);
+            const TextureSampling& GetSampling() const { return m_Sampling; }
 
             uint32_t ID() const { return m_TextureID; }
+            uint64_t BindlessHandle() const;
             int32_t Width() const { return m_Width; }
             int32_t Height() const { return m_Height; }
             int32_t Channels() const { return m_Channels; }
             GLenum GetInternalFormat() const { return m_InternalFormat; }
             GLenum GetDataFormat() const { return m_DataFormat; }
             void* TextureData() const { return m_Data; }
+            uint32_t Revision() const { return m_Revision; }
+            bool Opaque() const { return m_Opaque; }
             bool operator==(const Texture& other) const { return m_TextureID == other.m_TextureID; }
 
         private:
             int32_t m_Width{0}, m_Height{0}, m_Channels{0};
             void* m_Data{nullptr};
             uint32_t m_TextureID{0};
+            mutable uint64_t m_BindlessHandle{0};
+            uint32_t m_Revision{0};
             bool m_FromImageFile{false};
+            bool m_Opaque{true};
             GLenum m_InternalFormat{0}, m_DataFormat{0};
+            TextureSampling m_Sampling;
     };
 
     class SubTexture 
@@ -53,10 +82,76 @@ namespace DviCore
             GLenum GetDataFormat() const { return m_DataFormat; }
             static std::shared_ptr<SubTexture> MakeSubTexture(const std::shared_ptr<Texture>& texture, const glm::vec2& coords, const glm::vec2& cellSize, const glm::vec2& spriteSize = {1.0f, 1.0f});
 
+        private:
+            void SetRegion(const std::shared_ptr<Texture>& texture, const glm::vec2& min, const glm::vec2& max);
+
         private:
             static const uint32_t NUMBER_OF_TEXTURE_COORDS = 4;
             std::shared_ptr<Texture> m_Texture;
             glm::vec2 m_TexCoords[NUMBER_OF_TEXTURE_COORDS];
             GLenum m_InternalFormat{0}, m_DataFormat{0};
+
+            friend class TextureAtlas;
+    };
+
+    struct TextureAtlasSpecifications 
+    {
+        int32_t InitialPageSize{512};
+        int32_t MaxPageSize{2048};
+        uint32_t MaxPages{8};
+        int32_t Padding{1};
+    };
+
+    // Packs images at runtime into a few large RGBA pages with skyline packing. Pages double in size until MaxPageSize, then
+    // new pages are added. The SubTextures it hands out stay valid, their page and UVs are updated when the atlas grows or
+    // repacks.
+    class TextureAtlas 
+    {
+        public:
+            TextureAtlas(const TextureAtlasSpecifications& specification = TextureAtlasSpecifications());
+            ~TextureAtlas() = default;
+
+            std::shared_ptr<SubTexture> Add(const std::string& name, const std::filesystem::path& path, bool flip = true);
+            std::shared_ptr<SubTexture> Add(const std::string& name, const uint8_t* pixels, int32_t width, int32_t height);
+            std::shared_ptr<SubTexture> Get(const std::string& name) const;
+            void Remove(const std::string& name);
+            void Repack();
+
+            uint32_t PageCount() const { return static_cast<uint32_t>(m_Pages.size()); }
+            const std::shared_ptr<Texture>& Page(uint32_t index) const { return m_Pages[index].PageTexture; }
+
+        private:
+            struct SkylineNode 
+            {
+                int32_t X{0}, Y{0}, Width{0};
+            };
+
+            struct AtlasPage 
+            {
+                std::shared_ptr<Texture> PageTexture;
+                int32_t Size{0};
+                std::vector<SkylineNode> Skyline;
+            };
+
+            struct Entry 
+            {
+                std::vector<uint8_t> Pixels;
+                int32_t Width{0}, Height{0};
+                uint32_t PageIndex{0};
+                int32_t X{0}, Y{0};
+                std::shared_ptr<SubTexture> Region;
+            };
+
+            bool Place(Entry& entry);
+            bool Insert(AtlasPage& page, int32_t width, int32_t height, int32_t& x, int32_t& y);
+            void Grow(uint32_t page_index);
+            void Upload(const Entry& entry);
+            void UpdateRegion(Entry& entry);
+            AtlasPage CreatePage(int32_t size) const;
+
+        private:
+            TextureAtlasSpecifications m_Specification;
+            std::vector<AtlasPage> m_Pages;
+            std::unordered_map<std::string, Entry> m_Entries;
     };
 }
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "GL_TextureArray.hpp"
+#include "GL_StateCache.hpp"
+#include "Assert.hpp"
+
+#include <algorithm>
+
+namespace DviCore
+{
+    static const size_t ARRAY_BYTES_BUDGET = 64 * 1024 * 1024;
+
+    static int32_t MipLevels(int32_t width, int32_t height)
+    {
+        int32_t levels = 1;
+        for(int32_t size = std::max(width, height); size > 1; size >>= 1)
+            levels++;
+
+        return levels;
+    }
+
+    TextureArray::TextureArray(int32_t width, int32_t height, GLenum internal_format, const TextureSampling& sampling, uint32_t layers) :
+        m_Width(width), m_Height(height), m_InternalFormat(internal_format), m_Sampling(sampling), m_Capacity(layers)
+    {
+        int32_t max_layers = 0;
+        glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &max_layers);
+        m_Capacity = std::min<uint32_t>(m_Capacity, max_layers);
+        m_Levels = MipLevels(width, height);
+
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_TextureID);
+        glTextureParameteri(m_TextureID, GL_TEXTURE_MIN_FILTER, m_Sampling.MinFilter);
+        glTextureParameteri(m_TextureID, GL_TEXTURE_MAG_FILTER, m_Sampling.MagFilter);
+        glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_S, m_Sampling.Wrap);
+        glTextureParameteri(m_TextureID, GL_TEXTURE_WRAP_T, m_Sampling.Wrap);
+        glTextureStorage3D(m_TextureID, m_Levels, m_InternalFormat, m_Width, m_Height, m_Capacity);
+    }
+
+    TextureArray::~TextureArray()
+    {
+        GLStateCache::DeleteTexture(m_TextureID);
+    }
+
+    bool TextureArray::Matches(const Texture& texture) const
+    {
+        return texture.Width() == m_Width && texture.Height() == m_Height && texture.GetInternalFormat() == m_InternalFormat &&
+            texture.GetSampling() == m_Sampling;
+    }
+
+    uint32_t TextureArray::Add(const Texture& texture)
+    {
+        DVIMANA_ASSERT(Matches(texture) && !Full(), "Texture doesn't fit this texture array!");
+
+        uint32_t layer = m_LayerCount;
+        if(!m_FreeLayers.empty())
+        {
+            layer = m_FreeLayers.back();
+            m_FreeLayers.pop_back();
+        }
+        else
+        {
+            m_LayerCount++;
+        }
+
+        Copy(texture, layer);
+        return layer;
+    }
+
+    void TextureArray::Copy(const Texture& texture, uint32_t layer)
+    {
+        for(int32_t level = 0; level < m_Levels; level++)
+        {
+            int32_t width = std::max(1, m_Width >> level);
+            int32_t height = std::max(1, m_Height >> level);
+            glCopyImageSubData(texture.ID(), GL_TEXTURE_2D, level, 0, 0, 0, m_TextureID, GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, width, height, 1);
+        }
+    }
+
+    void TextureArray::Release(uint32_t layer)
+    {
+        m_FreeLayers.push_back(layer);
+    }
+
+    TextureLayer TextureArrayCache::Locate(const std::shared_ptr<Texture>& texture)
+    {
+        auto found = m_Entries.find(texture.get());
+        if(found != m_Entries.end())
+        {
+            Entry& entry = found->second;
+            if(!entry.Owner.expired())
+            {
+                // Textures updated with SetData since their copy (atlas pages) are copied into their layer again.
+                if(entry.Revision != texture->Revision())
+                {
+                    m_Arrays[entry.Location.Array]->Copy(*texture, entry.Location.Layer);
+                    entry.Revision = texture->Revision();
+                }
+
+                return entry.Location;
+            }
+
+            // The texture died and a new one took its address, its old layer is free again.
+            m_Arrays[found->second.Location.Array]->Release(found->second.Location.Layer);
+            m_Entries.erase(found);
+        }
+
+        auto pick = [&]()
+        {
+            for(uint32_t i = 0; i < m_Arrays.size(); i++)
+            {
+                if(m_Arrays[i]->Matches(*texture) && !m_Arrays[i]->Full())
+                    return i;
+            }
+
+            return static_cast<uint32_t>(m_Arrays.size());
+        };
+
+        uint32_t array = pick();
+        if(array == m_Arrays.size())
+        {
+            ReleaseExpired();
+            array = pick();
+        }
+
+        if(array == m_Arrays.size())
+        {
+            size_t layer_bytes = static_cast<size_t>(texture->Width()) * texture->Height() * (texture->GetInternalFormat() == GL_RGB8 ? 3 : 4);
+            uint32_t layers = static_cast<uint32_t>(std::clamp<size_t>(ARRAY_BYTES_BUDGET / std::max<size_t>(layer_bytes, 1), 1, TextureArray::MAX_LAYERS));
+            m_Arrays.push_back(std::make_unique<TextureArray>(texture->Width(), texture->Height(), texture->GetInternalFormat(), texture->GetSampling(), layers));
+        }
+
+        TextureLayer location{ array, m_Arrays[array]->Add(*texture) };
+        m_Entries[texture.get()] = { texture, location, texture->Revision() };
+        return location;
+    }
+
+    void TextureArrayCache::Clear()
+    {
+        m_Entries.clear();
+        m_Arrays.clear();
+    }
+
+    void TextureArrayCache::ReleaseExpired()
+    {
+        for(auto it = m_Entries.begin(); it != m_Entries.end();)
+        {
+            if(it->second.Owner.expired())
+            {
+                m_Arrays[it->second.Location.Array]->Release(it->second.Location.Layer);
+                it = m_Entries.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "GL_Texture.hpp"
+
+namespace DviCore
+{
+    class TextureArray
+    {
+        public:
+            static const uint32_t MAX_LAYERS = 256;
+
+            TextureArray(int32_t width, int32_t height, GLenum internal_format, const TextureSampling& sampling, uint32_t layers);
+            ~TextureArray();
+
+            bool Matches(const Texture& texture) const;
+            bool Full() const { return m_FreeLayers.empty() && m_LayerCount == m_Capacity; }
+
+            uint32_t Add(const Texture& texture);
+            void Copy(const Texture& texture, uint32_t layer);
+            void Release(uint32_t layer);
+
+            uint32_t ID() const { return m_TextureID; }
+            uint32_t Capacity() const { return m_Capacity; }
+
+        private:
+            int32_t m_Width{0}, m_Height{0};
+            GLenum m_InternalFormat{0};
+            TextureSampling m_Sampling;
+            int32_t m_Levels{1};
+            uint32_t m_TextureID{0};
+            uint32_t m_Capacity{0};
+            uint32_t m_LayerCount{0};
+            std::vector<uint32_t> m_FreeLayers;
+    };
+
+    struct TextureLayer
+    {
+        uint32_t Array{0};
+        uint32_t Layer{0};
+    };
+
+    // Copies textures into GL_TEXTURE_2D_ARRAY layers grouped by size, format and sampling state, so a batch binds one array
+    // per group instead of one slot per texture.
+    class TextureArrayCache
+    {
+        public:
+            TextureArrayCache() = default;
+            ~TextureArrayCache() = default;
+
+            TextureLayer Locate(const std::shared_ptr<Texture>& texture);
+            uint32_t ArrayID(uint32_t array) const { return m_Arrays[array]->ID(); }
+            void Clear();
+
+        private:
+            void ReleaseExpired();
+
+        private:
+            struct Entry
+            {
+                std::weak_ptr<Texture> Owner;
+                TextureLayer Location;
+                uint32_t Revision{0};
+            };
+
+            std::vector<std::unique_ptr<TextureArray>> m_Arrays;
+            std::unordered_map<const Texture*, Entry> m_Entries;
+    };
+}
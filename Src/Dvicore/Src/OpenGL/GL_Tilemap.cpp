@@ -0,0 +1,276 @@
+#include "GL_Tilemap.hpp"
+#include "GL_StateCache.hpp"
+#include "GL_Renderer.hpp"
+#include "Assert.hpp"
+#include "Instrument.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace DviCore
+{
+    struct TileVertex
+    {
+        glm::vec2 Position;
+        glm::vec2 TexCoords;
+    };
+
+    static_assert(Tilemap::MAX_CHUNK_SIZE * Tilemap::MAX_CHUNK_SIZE * 4 <= UINT16_MAX + 1, "Chunks must fit 16-bit indices!");
+
+    // Frustum planes in the map's own space, so chunk bounds are tested without transforming them.
+    static std::array<glm::vec4, 6> FrustumPlanes(const glm::mat4& clip_from_map)
+    {
+        glm::vec4 rows[4];
+        for(int32_t i = 0; i < 4; i++)
+            rows[i] = { clip_from_map[0][i], clip_from_map[1][i], clip_from_map[2][i], clip_from_map[3][i] };
+
+        std::array<glm::vec4, 6> planes;
+        for(int32_t i = 0; i < 3; i++)
+        {
+            planes[i * 2 + 0] = rows[3] + rows[i];
+            planes[i * 2 + 1] = rows[3] - rows[i];
+        }
+
+        return planes;
+    }
+
+    static bool BoxInFrustum(const std::array<glm::vec4, 6>& planes, const glm::vec2& min, const glm::vec2& max)
+    {
+        for(const glm::vec4& plane : planes)
+        {
+            glm::vec2 corner{ plane.x >= 0.0f ? max.x : min.x, plane.y >= 0.0f ? max.y : min.y };
+            if(plane.x * corner.x + plane.y * corner.y + plane.w < 0.0f)
+                return false;
+        }
+
+        return true;
+    }
+
+    // Intersects the frustum's corner rays with the map plane, so only the chunks under the camera are visited. Returns false
+    // when a ray misses the plane, the caller then tests every chunk.
+    static bool VisibleRect(const glm::mat4& clip_from_map, glm::vec2& min, glm::vec2& max)
+    {
+        glm::mat4 map_from_clip = glm::inverse(clip_from_map);
+        min = glm::vec2(std::numeric_limits<float>::max());
+        max = glm::vec2(std::numeric_limits<float>::lowest());
+
+        const glm::vec2 corners[] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+        for(const glm::vec2& corner : corners)
+        {
+            glm::vec4 near = map_from_clip * glm::vec4(corner, -1.0f, 1.0f);
+            glm::vec4 far = map_from_clip * glm::vec4(corner, 1.0f, 1.0f);
+            glm::vec3 from = glm::vec3(near) / near.w, to = glm::vec3(far) / far.w;
+
+            float depth = to.z - from.z;
+            if(std::abs(depth) < 1e-6f)
+                return false;
+
+            float t = -from.z / depth;
+            if(t < 0.0f || t > 1.0f)
+                return false;
+
+            glm::vec2 point = glm::vec2(from + (to - from) * t);
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+
+        return true;
+    }
+
+    Tilemap::Tilemap(const TilemapSpecifications& specification)
+        : m_Specification(specification)
+    {
+        DVIMANA_ASSERT(m_Specification.ChunkSize > 0 && m_Specification.ChunkSize <= MAX_CHUNK_SIZE, "Tilemap chunk size is out of range!");
+        uint32_t chunk_size = m_Specification.ChunkSize;
+        m_ChunksX = (m_Specification.Width + chunk_size - 1) / chunk_size;
+        m_ChunksY = (m_Specification.Height + chunk_size - 1) / chunk_size;
+        m_Tiles.resize(static_cast<size_t>(m_Specification.Width) * m_Specification.Height, EMPTY_TILE);
+        m_Chunks.resize(static_cast<size_t>(m_ChunksX) * m_ChunksY);
+
+        // Every chunk shares one index buffer sized for a full chunk.
+        uint32_t max_quads = chunk_size * chunk_size;
+        std::vector<uint16_t> indices(max_quads * 6);
+        for(uint32_t i = 0, offset = 0; i < indices.size(); i += 6, offset += 4)
+        {
+            indices[i + 0] = offset + 0;
+            indices[i + 1] = offset + 1;
+            indices[i + 2] = offset + 2;
+            indices[i + 3] = offset + 2;
+            indices[i + 4] = offset + 3;
+            indices[i + 5] = offset + 0;
+        }
+
+        glCreateBuffers(1, &m_IndexBufferID);
+        glNamedBufferStorage(m_IndexBufferID, indices.size() * sizeof(uint16_t), indices.data(), 0);
+
+        glCreateVertexArrays(1, &m_VertexArrayID);
+        glVertexArrayElementBuffer(m_VertexArrayID, m_IndexBufferID);
+
+        glEnableVertexArrayAttrib(m_VertexArrayID, 0);
+        glVertexArrayAttribFormat(m_VertexArrayID, 0, 2, GL_FLOAT, GL_FALSE, offsetof(TileVertex, Position));
+        glVertexArrayAttribBinding(m_VertexArrayID, 0, 0);
+
+        glEnableVertexArrayAttrib(m_VertexArrayID, 1);
+        glVertexArrayAttribFormat(m_VertexArrayID, 1, 2, GL_FLOAT, GL_FALSE, offsetof(TileVertex, TexCoords));
+        glVertexArrayAttribBinding(m_VertexArrayID, 1, 0);
+
+        if(m_Specification.Tileset == nullptr)
+            m_PlainTexture = std::make_shared<Texture>(1, 1);
+
+        m_Shader = std::make_shared<Shader>("TilemapShader", "Shaders/TilemapVertex.glsl", "Shaders/TilemapFragment.glsl");
+    }
+
+    Tilemap::~Tilemap()
+    {
+        for(Chunk& chunk : m_Chunks)
+        {
+            if(chunk.BufferID != 0)
+                GLStateCache::DeleteBuffer(chunk.BufferID);
+        }
+
+        GLStateCache::DeleteBuffer(m_IndexBufferID);
+        GLStateCache::DeleteVertexArray(m_VertexArrayID);
+    }
+
+    void Tilemap::SetTile(uint32_t x, uint32_t y, uint16_t tile)
+    {
+        DVIMANA_ASSERT(x < m_Specification.Width && y < m_Specification.Height, "Tile is out of the map!");
+        uint16_t& current = m_Tiles[static_cast<size_t>(y) * m_Specification.Width + x];
+        if(current == tile)
+            return;
+
+        current = tile;
+        MarkDirty(x, y);
+    }
+
+    uint16_t Tilemap::GetTile(uint32_t x, uint32_t y) const
+    {
+        DVIMANA_ASSERT(x < m_Specification.Width && y < m_Specification.Height, "Tile is out of the map!");
+        return m_Tiles[static_cast<size_t>(y) * m_Specification.Width + x];
+    }
+
+    void Tilemap::Fill(uint16_t tile)
+    {
+        std::fill(m_Tiles.begin(), m_Tiles.end(), tile);
+        for(Chunk& chunk : m_Chunks)
+            chunk.Dirty = true;
+    }
+
+    void Tilemap::MarkDirty(uint32_t x, uint32_t y)
+    {
+        uint32_t chunk_size = m_Specification.ChunkSize;
+        m_Chunks[(y / chunk_size) * m_ChunksX + x / chunk_size].Dirty = true;
+    }
+
+    // Chunks are rebuilt lazily, only once they're visible, into a new immutable buffer that replaces the old one.
+    void Tilemap::Rebuild(uint32_t chunk_x, uint32_t chunk_y)
+    {
+        Chunk& chunk = m_Chunks[chunk_y * m_ChunksX + chunk_x];
+        uint32_t chunk_size = m_Specification.ChunkSize;
+        uint32_t first_x = chunk_x * chunk_size, first_y = chunk_y * chunk_size;
+        uint32_t last_x = std::min(first_x + chunk_size, m_Specification.Width);
+        uint32_t last_y = std::min(first_y + chunk_size, m_Specification.Height);
+
+        float tile_size = m_Specification.TileSize;
+        glm::vec2 cell = 1.0f / glm::vec2(m_Specification.TilesetColumns, m_Specification.TilesetRows);
+        uint32_t cell_count = m_Specification.TilesetColumns * m_Specification.TilesetRows;
+
+        std::vector<TileVertex> vertices;
+        vertices.reserve(static_cast<size_t>(last_x - first_x) * (last_y - first_y) * 4);
+        for(uint32_t y = first_y; y < last_y; y++)
+        {
+            for(uint32_t x = first_x; x < last_x; x++)
+            {
+                uint16_t tile = m_Tiles[static_cast<size_t>(y) * m_Specification.Width + x];
+                if(tile == EMPTY_TILE)
+                    continue;
+
+                uint32_t index = (tile - 1u) % cell_count;
+                glm::vec2 tex_min{ (index % m_Specification.TilesetColumns) * cell.x, 1.0f - (index / m_Specification.TilesetColumns + 1) * cell.y };
+                glm::vec2 tex_max = tex_min + cell;
+                glm::vec2 min = glm::vec2(x, y) * tile_size, max = min + tile_size;
+
+                vertices.push_back({ { min.x, min.y }, { tex_min.x, tex_min.y } });
+                vertices.push_back({ { max.x, min.y }, { tex_max.x, tex_min.y } });
+                vertices.push_back({ { max.x, max.y }, { tex_max.x, tex_max.y } });
+                vertices.push_back({ { min.x, max.y }, { tex_min.x, tex_max.y } });
+            }
+        }
+
+        if(chunk.BufferID != 0)
+            GLStateCache::DeleteBuffer(chunk.BufferID);
+
+        chunk.BufferID = 0;
+        chunk.QuadCount = static_cast<uint32_t>(vertices.size() / 4);
+        chunk.Dirty = false;
+        m_Status.ChunkRebuilds++;
+
+        if(chunk.QuadCount == 0)
+            return;
+
+        glCreateBuffers(1, &chunk.BufferID);
+        glNamedBufferStorage(chunk.BufferID, vertices.size() * sizeof(TileVertex), vertices.data(), 0);
+    }
+
+    void Tilemap::Draw(const glm::mat4& transform)
+    {
+        DVI_PROFILE_SCOPE("Tilemap::Draw");
+        glm::mat4 clip_from_map = Renderer::GetFrameConstants().ViewProjection * transform;
+        std::array<glm::vec4, 6> planes = FrustumPlanes(clip_from_map);
+
+        float chunk_extent = m_Specification.ChunkSize * m_Specification.TileSize;
+        glm::vec2 map_extent = glm::vec2(m_Specification.Width, m_Specification.Height) * m_Specification.TileSize;
+        uint32_t first_x = 0, first_y = 0, last_x = m_ChunksX, last_y = m_ChunksY;
+
+        glm::vec2 min, max;
+        if(VisibleRect(clip_from_map, min, max))
+        {
+            glm::vec2 first = glm::floor(min / chunk_extent), last = glm::floor(max / chunk_extent) + 1.0f;
+            first_x = static_cast<uint32_t>(std::clamp(first.x, 0.0f, static_cast<float>(m_ChunksX)));
+            first_y = static_cast<uint32_t>(std::clamp(first.y, 0.0f, static_cast<float>(m_ChunksY)));
+            last_x = static_cast<uint32_t>(std::clamp(last.x, 0.0f, static_cast<float>(m_ChunksX)));
+            last_y = static_cast<uint32_t>(std::clamp(last.y, 0.0f, static_cast<float>(m_ChunksY)));
+        }
+
+        bool bound = false;
+        for(uint32_t chunk_y = first_y; chunk_y < last_y; chunk_y++)
+        {
+            for(uint32_t chunk_x = first_x; chunk_x < last_x; chunk_x++)
+            {
+                glm::vec2 chunk_min = glm::vec2(chunk_x, chunk_y) * chunk_extent;
+                glm::vec2 chunk_max = glm::min(chunk_min + chunk_extent, map_extent);
+                if(!BoxInFrustum(planes, chunk_min, chunk_max))
+                    continue;
+
+                Chunk& chunk = m_Chunks[chunk_y * m_ChunksX + chunk_x];
+                if(chunk.Dirty)
+                    Rebuild(chunk_x, chunk_y);
+
+                if(chunk.QuadCount == 0)
+                    continue;
+
+                if(!bound)
+                {
+                    m_Shader->Bind();
+                    m_Shader->Uniform("u_Transform", transform);
+                    (m_Specification.Tileset != nullptr ? m_Specification.Tileset : m_PlainTexture)->Bind(0);
+                    GLStateCache::BindVertexArray(m_VertexArrayID);
+                    GLStateCache::DepthMask(false);
+                    bound = true;
+                }
+
+                glVertexArrayVertexBuffer(m_VertexArrayID, 0, chunk.BufferID, 0, sizeof(TileVertex));
+                glDrawElements(GL_TRIANGLES, chunk.QuadCount * 6, GL_UNSIGNED_SHORT, nullptr);
+
+                m_Status.VisibleChunks++;
+                m_Status.TileCount += chunk.QuadCount;
+            }
+        }
+
+        if(bound)
+            GLStateCache::DepthMask(true);
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "GL_Shader.hpp"
+#include "GL_Texture.hpp"
+
+namespace DviCore
+{
+    struct TilemapSpecifications
+    {
+        uint32_t Width{256};
+        uint32_t Height{256};
+        uint32_t ChunkSize{64};
+        float TileSize{1.0f};
+        std::shared_ptr<Texture> Tileset{nullptr};
+        uint32_t TilesetColumns{1};
+        uint32_t TilesetRows{1};
+    };
+
+    // A tile grid split into square chunks. Every chunk's quads are built once into an immutable vertex buffer and only rebuilt
+    // when one of its tiles changes, drawing culls whole chunks, so a frame costs the chunks the camera sees.
+    // Tile 0 is empty, tile n samples cell n - 1 of the tileset counted row by row from its top left.
+    class Tilemap
+    {
+        public:
+            static const uint16_t EMPTY_TILE = 0;
+            static const uint32_t MAX_CHUNK_SIZE = 128;
+
+            Tilemap(const TilemapSpecifications& specification = TilemapSpecifications());
+            ~Tilemap();
+
+            void SetTile(uint32_t x, uint32_t y, uint16_t tile);
+            uint16_t GetTile(uint32_t x, uint32_t y) const;
+            void Fill(uint16_t tile);
+
+            // The camera comes from the renderer's frame constants, update them before drawing. Tiles are a background and
+            // don't write depth, whatever is drawn after them at the same depth stays visible.
+            void Draw(const glm::mat4& transform);
+
+            const TilemapSpecifications& GetSpecification() const { return m_Specification; }
+            uint32_t ChunkCount() const { return static_cast<uint32_t>(m_Chunks.size()); }
+
+            struct TilemapStatus
+            {
+                uint32_t VisibleChunks{0};
+                uint32_t ChunkRebuilds{0};
+                uint32_t TileCount{0};
+            };
+
+            const TilemapStatus& Status() const { return m_Status; }
+            void StatusReset() { m_Status = TilemapStatus(); }
+
+        private:
+            struct Chunk
+            {
+                uint32_t BufferID{0};
+                uint32_t QuadCount{0};
+                bool Dirty{true};
+            };
+
+            void Rebuild(uint32_t chunk_x, uint32_t chunk_y);
+            void MarkDirty(uint32_t x, uint32_t y);
+
+        private:
+            TilemapSpecifications m_Specification;
+            uint32_t m_ChunksX{0}, m_ChunksY{0};
+            std::vector<uint16_t> m_Tiles;
+            std::vector<Chunk> m_Chunks;
+
+            uint32_t m_VertexArrayID{0};
+            uint32_t m_IndexBufferID{0};
+            std::shared_ptr<Shader> m_Shader{nullptr};
+            std::shared_ptr<Texture> m_PlainTexture{nullptr};
+            TilemapStatus m_Status;
+    };
+}
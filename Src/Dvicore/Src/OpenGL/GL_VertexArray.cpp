@@ -1,4 +1,5 @@
 #include "GL_VertexArray.hpp"
+#include "GL_StateCache.hpp"
 #include "Log.hpp"
 
 namespace DviCore 
@@ -10,17 +11,17 @@ namespace DviCore
 
     VertexArray::~VertexArray() 
     {
-		glDeleteVertexArrays(1, &m_VertexArrayID);
+		GLStateCache::DeleteVertexArray(m_VertexArrayID);
 	}
 
     void VertexArray::Bind() const 
     {
-		glBindVertexArray(m_VertexArrayID);
+		GLStateCache::BindVertexArray(m_VertexArrayID);
 	}
 
     void VertexArray::Unbind() const 
     {
-		glBindVertexArray(0);
+		GLStateCache::BindVertexArray(0);
 	}
 
     static GLenum GetDataType(BufferStride component) 
@@ -42,7 +43,7 @@ namespace DviCore
 
     void VertexArray::EmplaceVtxBuffer(const std::shared_ptr<VertexBuffer>& buffer) 
     {
-        glBindVertexArray(m_VertexArrayID);
+        GLStateCache::BindVertexArray(m_VertexArrayID);
         buffer->Bind();
         const auto& layout = buffer->GetLayout();
         const auto& elements = layout.GetElements();
@@ -66,7 +67,7 @@ namespace DviCore
 
     void VertexArray::EmplaceIdxBuffer(const std::shared_ptr<IndexBuffer>& buffer) 
     {
-        glBindVertexArray(m_VertexArrayID);
+        GLStateCache::BindVertexArray(m_VertexArrayID);
 		m_IdxBuffer = buffer;
 		m_IdxBuffer->Bind();
     }
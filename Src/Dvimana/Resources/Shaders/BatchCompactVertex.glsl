@@ -0,0 +1,34 @@
+#version 440 core
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec4 a_Color;
+layout(location = 2) in vec2 a_Texcoord;
+layout(location = 3) in uint a_TexIndex;
+layout(location = 4) in float a_TilingFactor;
+layout(location = 5) in vec4 a_Shape;
+
+out vec2    v_Texcoord;
+out vec4    v_Color;
+flat out int v_TexIndex;
+out float   v_TilingFactor;
+flat out vec4 v_Shape;
+
+layout(std140, binding = 0) uniform FrameConstants
+{
+    mat4    u_View;
+    mat4    u_Projection;
+    mat4    u_ViewProjection;
+    vec2    u_ViewportSize;
+    float   u_Time;
+};
+
+void main()
+{
+    v_Color             = a_Color;
+    v_Texcoord          = a_Texcoord;
+    v_TexIndex          = int(a_TexIndex);
+    v_TilingFactor     = a_TilingFactor;
+    v_Shape             = a_Shape;
+
+    gl_Position         = u_ViewProjection * vec4(a_Position, 1.0);
+}
\ No newline at end of file
@@ -1,16 +1,111 @@
 #version 440 core
 
+// The renderer injects BATCH_TEXTURES_SLOTS, BATCH_TEXTURES_ARRAYS or BATCH_TEXTURES_BINDLESS for its texture backend and
+// BATCH_PIPELINE per program, 0 draws color only, 1 samples a single fixed texture, 2 indexes the texture table per fragment.
+#ifdef BATCH_TEXTURES_BINDLESS
+#extension GL_ARB_bindless_texture : require
+#endif
+
+#ifndef BATCH_PIPELINE
+#define BATCH_PIPELINE 2
+#endif
+
 layout(location = 0) out vec4 FragColor;
 
 in vec2     v_Texcoord;
 in vec4     v_Color;
-in float    v_TexIndex;
+flat in int v_TexIndex;
 in float    v_TilingFactor;
+flat in vec4 v_Shape;
+
+#ifdef BATCH_EDGE_AA
+noperspective in vec4 v_Edge;
+flat in vec4 v_TexRect;
+#endif
+
+#if defined(BATCH_TEXTURES_ARRAYS)
+// The texture index holds the bound array in its high bits and the layer inside that array in its low 8 bits.
+layout(binding = 0) uniform sampler2DArray  u_Textures[32];
+#elif defined(BATCH_TEXTURES_BINDLESS)
+layout(std430, binding = 1) readonly buffer TextureHandles
+{
+    sampler2D u_Handles[];
+};
+#else
+layout(binding = 0) uniform sampler2D   u_Textures[32];
+#endif
 
-uniform sampler2D   u_Textures[32];
+// Coverage of a rounded box in a space where the quad's shorter half side is 1, so a full corner radius on a square is a
+// circle. The fade never drops below one pixel, shapes stay anti-aliased at any scale.
+float ShapeCoverage(vec2 texcoord, vec4 shape)
+{
+    vec2 extent     = shape.w >= 1.0 ? vec2(shape.w, 1.0) : vec2(1.0, 1.0 / shape.w);
+    vec2 position   = (texcoord * 2.0 - 1.0) * extent;
+    vec2 corner     = abs(position) - extent + shape.z;
+    float distance  = length(max(corner, 0.0)) + min(max(corner.x, corner.y), 0.0) - shape.z;
+    float fade      = max(shape.y, fwidth(distance));
+
+    return (1.0 - smoothstep(-fade, 0.0, distance)) * smoothstep(-shape.x - fade, -shape.x, distance);
+}
+
+// Pixel coverage of the quad from the distances to its center along both axes, the rim added by the vertex shader fades
+// out and quads thinner than a pixel keep their share of it.
+float EdgeCoverage(vec4 edge)
+{
+    vec2 inside     = clamp(edge.zw - abs(edge.xy) + 0.5, 0.0, 1.0);
+    return inside.x * inside.y;
+}
+
+float GlyphCoverage(float distance, vec4 shape)
+{
+    float fade      = max(shape.y, fwidth(distance) * 0.5);
+    return smoothstep(0.5 - fade, 0.5 + fade, distance);
+}
+
+int TextureSlot(int index)
+{
+#ifdef BATCH_TEXTURES_ARRAYS
+    return index >> 8;
+#else
+    return index;
+#endif
+}
+
+// Only texture arrays read the index again, for the layer inside the slot.
+vec4 Fetch(int slot, int index, vec2 texcoord)
+{
+#if defined(BATCH_TEXTURES_ARRAYS)
+    return texture(u_Textures[slot], vec3(texcoord, float(index & 255)));
+#elif defined(BATCH_TEXTURES_BINDLESS)
+    return texture(u_Handles[slot], texcoord);
+#else
+    return texture(u_Textures[slot], texcoord);
+#endif
+}
 
 void main()
 {
-    int index = int(v_TexIndex);
-    FragColor = texture(u_Textures[index], v_Texcoord * v_TilingFactor) * v_Color;
+#ifdef BATCH_EDGE_AA
+    vec2 texcoord   = clamp(v_Texcoord, min(v_TexRect.xy, v_TexRect.zw), max(v_TexRect.xy, v_TexRect.zw));
+#else
+    vec2 texcoord   = v_Texcoord;
+#endif
+
+    // Plain quads carry a zero thickness, glyphs a negative one. Both coverages are evaluated for every fragment so their
+    // derivatives stay defined, glyphs read the distance to their edge from the atlas alpha.
+#if BATCH_PIPELINE == 0
+    vec4 texel      = vec4(1.0);
+#elif BATCH_PIPELINE == 1
+    vec4 texel      = Fetch(BATCH_SINGLE_SLOT, v_TexIndex, texcoord * v_TilingFactor);
+#else
+    vec4 texel      = Fetch(TextureSlot(v_TexIndex), v_TexIndex, texcoord * v_TilingFactor);
+#endif
+    float coverage  = ShapeCoverage(v_Texcoord, v_Shape);
+    float glyph     = GlyphCoverage(texel.a, v_Shape);
+
+    FragColor       = v_Shape.x < 0.0 ? vec4(v_Color.rgb, v_Color.a * glyph) : texel * v_Color;
+    FragColor.a    *= v_Shape.x > 0.0 ? coverage : 1.0;
+#ifdef BATCH_EDGE_AA
+    FragColor.a    *= EdgeCoverage(v_Edge);
+#endif
 }
\ No newline at end of file
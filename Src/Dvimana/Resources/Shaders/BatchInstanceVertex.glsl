@@ -0,0 +1,63 @@
+#version 440 core
+
+layout(location = 0) in vec3 a_AxisX;
+layout(location = 1) in vec3 a_AxisY;
+layout(location = 2) in vec3 a_Translation;
+layout(location = 3) in vec4 a_Color;
+layout(location = 4) in vec4 a_TexRect;
+layout(location = 5) in float a_TexIndex;
+layout(location = 6) in float a_TilingFactor;
+layout(location = 7) in vec4 a_Shape;
+
+out vec2    v_Texcoord;
+out vec4    v_Color;
+flat out int v_TexIndex;
+out float   v_TilingFactor;
+flat out vec4 v_Shape;
+
+#ifdef BATCH_EDGE_AA
+noperspective out vec4 v_Edge;
+flat out vec4 v_TexRect;
+#endif
+
+layout(std140, binding = 0) uniform FrameConstants
+{
+    mat4    u_View;
+    mat4    u_Projection;
+    mat4    u_ViewProjection;
+    vec2    u_ViewportSize;
+    float   u_Time;
+};
+
+const vec2 c_Corners[4] = vec2[4](vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(0.5, 0.5), vec2(-0.5, 0.5));
+const vec2 c_TexCorners[4] = vec2[4](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0));
+
+void main()
+{
+    vec2 corner         = c_Corners[gl_VertexID];
+    vec2 texCorner      = c_TexCorners[gl_VertexID];
+
+#ifdef BATCH_EDGE_AA
+    // Widen the quad by a pixel on every side, the fragment shader fades the rim out by its pixel distance to the true edge.
+    // The axes are measured on screen at the quad's center.
+    vec4 center         = u_ViewProjection * vec4(a_Translation, 1.0);
+    vec2 pixels         = 0.5 * u_ViewportSize / max(abs(center.w), 1e-6);
+    vec2 extent         = vec2(length((u_ViewProjection * vec4(a_AxisX, 0.0)).xy * pixels), length((u_ViewProjection * vec4(a_AxisY, 0.0)).xy * pixels));
+    extent              = max(extent, vec2(1e-4));
+
+    corner             *= 1.0 + 2.0 / extent;
+    texCorner           = corner + 0.5;
+    v_Edge              = vec4(corner * extent, 0.5 * extent);
+    v_TexRect           = a_TexRect;
+#endif
+
+    vec3 position       = a_Translation + a_AxisX * corner.x + a_AxisY * corner.y;
+
+    v_Color             = a_Color;
+    v_Texcoord          = mix(a_TexRect.xy, a_TexRect.zw, texCorner);
+    v_TexIndex          = int(a_TexIndex);
+    v_TilingFactor      = a_TilingFactor;
+    v_Shape             = a_Shape;
+
+    gl_Position         = u_ViewProjection * vec4(position, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 440 core
+
+layout(location = 0) out vec4 FragColor;
+
+in vec4     v_Color;
+
+void main()
+{
+    FragColor = v_Color;
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#version 440 core
+
+layout(location = 0) out vec4 FragColor;
+
+in vec4     v_Color;
+
+layout(binding = 0) uniform sampler2D u_Texture;
+
+void main()
+{
+    // gl_PointCoord starts at the top left, textures are stored bottom up.
+    vec2 texcoord   = vec2(gl_PointCoord.x, 1.0 - gl_PointCoord.y);
+    FragColor       = texture(u_Texture, texcoord) * v_Color;
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#version 440 core
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec4 a_Color;
+layout(location = 2) in float a_Size;
+
+out vec4    v_Color;
+
+layout(std140, binding = 0) uniform FrameConstants
+{
+    mat4    u_View;
+    mat4    u_Projection;
+    mat4    u_ViewProjection;
+    vec2    u_ViewportSize;
+    float   u_Time;
+};
+
+void main()
+{
+    v_Color         = a_Color;
+    gl_PointSize    = a_Size;
+    gl_Position     = u_ViewProjection * vec4(a_Position, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#version 440 core
+
+layout(local_size_x = 64) in;
+
+struct Sprite
+{
+    vec4 AxisX;
+    vec4 AxisY;
+    vec4 Translation;
+    vec4 Color;
+};
+
+layout(std430, binding = 2) readonly buffer Sprites
+{
+    Sprite u_Sprites[];
+};
+
+layout(std430, binding = 3) writeonly buffer VisibleSprites
+{
+    Sprite u_Visible[];
+};
+
+layout(std430, binding = 4) buffer DrawCommand
+{
+    uint u_VertexCount;
+    uint u_InstanceCount;
+    uint u_First;
+    uint u_BaseInstance;
+};
+
+uniform int u_SpriteCount;
+
+layout(std140, binding = 0) uniform FrameConstants
+{
+    mat4    u_View;
+    mat4    u_Projection;
+    mat4    u_ViewProjection;
+    vec2    u_ViewportSize;
+    float   u_Time;
+};
+
+const vec2 c_Corners[4] = vec2[4](vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(0.5, 0.5), vec2(-0.5, 0.5));
+
+void main()
+{
+    uint index = gl_GlobalInvocationID.x;
+    if(index >= uint(u_SpriteCount))
+        return;
+
+    // Freed slots have collapsed axes.
+    Sprite sprite = u_Sprites[index];
+    if(sprite.AxisX.xyz == vec3(0.0) && sprite.AxisY.xyz == vec3(0.0))
+        return;
+
+    // Culled when all four corners are beyond the same clip plane.
+    vec3 below = vec3(1.0), above = vec3(1.0);
+    for(int i = 0; i < 4; i++)
+    {
+        vec3 position   = sprite.Translation.xyz + sprite.AxisX.xyz * c_Corners[i].x + sprite.AxisY.xyz * c_Corners[i].y;
+        vec4 clip       = u_ViewProjection * vec4(position, 1.0);
+        below          *= vec3(lessThan(clip.xyz, vec3(-clip.w)));
+        above          *= vec3(greaterThan(clip.xyz, vec3(clip.w)));
+    }
+
+    if(any(greaterThan(below + above, vec3(0.0))))
+        return;
+
+    uint slot = atomicAdd(u_InstanceCount, 1u);
+    u_Visible[slot] = sprite;
+}
\ No newline at end of file
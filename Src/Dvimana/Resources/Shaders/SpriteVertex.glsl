@@ -0,0 +1,38 @@
+#version 440 core
+
+struct Sprite
+{
+    vec4 AxisX;
+    vec4 AxisY;
+    vec4 Translation;
+    vec4 Color;
+};
+
+layout(std430, binding = 2) readonly buffer Sprites
+{
+    Sprite u_Sprites[];
+};
+
+out vec4    v_Color;
+
+layout(std140, binding = 0) uniform FrameConstants
+{
+    mat4    u_View;
+    mat4    u_Projection;
+    mat4    u_ViewProjection;
+    vec2    u_ViewportSize;
+    float   u_Time;
+};
+
+const vec2 c_Corners[6] = vec2[6](vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(0.5, 0.5), vec2(0.5, 0.5), vec2(-0.5, 0.5), vec2(-0.5, -0.5));
+
+void main()
+{
+    Sprite sprite       = u_Sprites[gl_InstanceID];
+    vec2 corner         = c_Corners[gl_VertexID];
+    vec3 position       = sprite.Translation.xyz + sprite.AxisX.xyz * corner.x + sprite.AxisY.xyz * corner.y;
+
+    v_Color             = sprite.Color;
+
+    gl_Position         = u_ViewProjection * vec4(position, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#version 440 core
+
+layout(location = 0) out vec4 FragColor;
+
+in vec2     v_Texcoord;
+
+layout(binding = 0) uniform sampler2D u_Tileset;
+
+void main()
+{
+    FragColor = texture(u_Tileset, v_Texcoord);
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#version 440 core
+
+layout(location = 0) in vec2 a_Position;
+layout(location = 1) in vec2 a_Texcoord;
+
+out vec2    v_Texcoord;
+
+uniform mat4 u_Transform;
+
+layout(std140, binding = 0) uniform FrameConstants
+{
+    mat4    u_View;
+    mat4    u_Projection;
+    mat4    u_ViewProjection;
+    vec2    u_ViewportSize;
+    float   u_Time;
+};
+
+void main()
+{
+    v_Texcoord      = a_Texcoord;
+    gl_Position     = u_ViewProjection * u_Transform * vec4(a_Position, 0.0, 1.0);
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "EditorLayer.hpp"
+#include <chrono>
 
 namespace Dvimana 
 { 
@@ -76,10 +77,141 @@ namespace Dvimana
         DviCore::Renderer::ClearColor({0.243, 0.243, 0.243, 1.0f});
         DviCore::Renderer::Clear();
         DviCore::BatchRenderer::StatusReset();
+        DviCore::GLStateCache::StatusReset();
+        DviCore::TextRenderer::StatusReset();
+        if(m_Scene->GetSpriteBuffer())
+            m_Scene->GetSpriteBuffer()->StatusReset();
+        if(m_BenchmarkTilemap)
+            m_TilemapEntity.GetComponent<TilemapComponent>().Map->StatusReset();
+        m_Scene->CachedLayerStatusReset();
+        if(m_BenchmarkParticles > 0)
+            m_ParticleEntity.GetComponent<ParticleSystemComponent>().System->StatusReset();
         m_Scene->OnUpdate(deltaTime);
+        RenderBenchmark();
         m_Framebuffer->Unbind();
     }
 
+    // A 4096 x 4096 map over a procedural 4 x 4 tileset, only the chunks under the camera should cost anything.
+    void EditorLayer::CreateBenchmarkTilemap()
+    {
+        const uint32_t cellSize = 16, cells = 4;
+        std::vector<uint32_t> pixels(cellSize * cells * cellSize * cells);
+        for(uint32_t y = 0; y < cellSize * cells; y++)
+        {
+            for(uint32_t x = 0; x < cellSize * cells; x++)
+            {
+                uint32_t cell = (y / cellSize) * cells + x / cellSize;
+                bool edge = x % cellSize == 0 || y % cellSize == 0;
+                uint8_t shade = edge ? 32 : (uint8_t)(64 + cell * 12);
+                pixels[y * cellSize * cells + x] = 0xFF000000 | (shade << 16) | ((255 - shade) << 8) | (cell * 16);
+            }
+        }
+
+        DviCore::TilemapSpecifications tilemapSpec{};
+        tilemapSpec.Width = 4096;
+        tilemapSpec.Height = 4096;
+        tilemapSpec.Tileset = std::make_shared<DviCore::Texture>(cellSize * cells, cellSize * cells);
+        tilemapSpec.Tileset->SetData(pixels.data(), 0, 0, cellSize * cells, cellSize * cells);
+        tilemapSpec.TilesetColumns = cells;
+        tilemapSpec.TilesetRows = cells;
+
+        m_TilemapEntity = m_Scene->CreateEntity("Tilemap");
+        auto& tilemap = m_TilemapEntity.AddComponent<TilemapComponent>(tilemapSpec);
+        for(uint32_t y = 0; y < tilemapSpec.Height; y++)
+        {
+            for(uint32_t x = 0; x < tilemapSpec.Width; x++)
+                tilemap.Map->SetTile(x, y, (uint16_t)(1 + (x * 7 + y * 13) % (cells * cells)));
+        }
+    }
+
+    // A 256 x 256 grid of background sprites in layer 0, behind everything else.
+    void EditorLayer::SetBenchmarkLayer(bool enabled)
+    {
+        for(Entity entity : m_LayerEntities)
+            m_Scene->DestroyEntity(entity);
+        m_LayerEntities.clear();
+
+        if(!enabled)
+            return;
+
+        const uint32_t gridSize = 256;
+        m_LayerEntities.reserve(gridSize * gridSize);
+        for(uint32_t y = 0; y < gridSize; y++)
+        {
+            for(uint32_t x = 0; x < gridSize; x++)
+            {
+                Entity entity = m_Scene->CreateEntity("Layer Sprite");
+                auto& transform = entity.GetComponent<TransformComponent>();
+                transform.Translation = { (float)x - gridSize * 0.5f, (float)y - gridSize * 0.5f, -0.5f };
+                transform.Scale = { 0.9f, 0.9f, 1.0f };
+                entity.AddComponent<SpriteComponent>(glm::vec4((float)x / gridSize, (float)y / gridSize, 0.5f, 1.0f));
+                entity.AddComponent<CachedLayerComponent>(0u);
+                m_LayerEntities.push_back(entity);
+            }
+        }
+    }
+
+    // Emits at the rate that keeps count particles alive once the first ones start dying.
+    void EditorLayer::SetBenchmarkParticles(uint32_t count)
+    {
+        if(m_BenchmarkParticles > 0)
+            m_Scene->DestroyEntity(m_ParticleEntity);
+
+        m_BenchmarkParticles = count;
+        if(count == 0)
+            return;
+
+        DviCore::ParticleSystemSpecifications particleSpec{};
+        particleSpec.MaxParticles = count;
+        particleSpec.EmissionRate = count / particleSpec.Lifetime;
+        particleSpec.Velocity = {0.0f, 4.0f};
+        particleSpec.VelocityVariation = {6.0f, 4.0f};
+        particleSpec.ColorBegin = {1.0f, 0.6f, 0.1f, 1.0f};
+        particleSpec.ColorEnd = {0.8f, 0.1f, 0.1f, 0.0f};
+        particleSpec.SizeBegin = 0.05f;
+
+        m_ParticleEntity = m_Scene->CreateEntity("Particles");
+        m_ParticleEntity.AddComponent<ParticleSystemComponent>(particleSpec);
+    }
+
+    void EditorLayer::RenderBenchmark()
+    {
+        if(m_BenchmarkQuads == 0)
+            return;
+
+        uint32_t side = (uint32_t)std::ceil(std::sqrt((float)m_BenchmarkQuads));
+        m_BenchmarkCamera.SetProjection(0.0f, (float)side, 0.0f, (float)side);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        DviCore::BatchRenderer::Begin(m_BenchmarkCamera);
+        for(uint32_t i = 0; i < m_BenchmarkQuads; i++)
+        {
+            float x = (float)(i % side);
+            float y = (float)(i / side);
+            glm::vec4 color{x / side, y / side, 0.5f, 1.0f};
+            if(m_BenchmarkShape == 0)
+                DviCore::BatchRenderer::Quad(glm::vec2{x + 0.5f, y + 0.5f}, glm::vec2{0.8f, 0.8f}, color, (float)i * 0.01f);
+            else if(m_BenchmarkShape == 4)
+                DviCore::BatchRenderer::Point(glm::vec3{x + 0.5f, y + 0.5f, 0.0f}, 4.0f, color);
+            else
+            {
+                glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3{x + 0.5f, y + 0.5f, 0.0f}) * glm::scale(glm::mat4(1.0f), glm::vec3{0.8f, 0.8f, 1.0f});
+                if(m_BenchmarkShape == 1)
+                    DviCore::BatchRenderer::Circle(transform, color, 0.3f);
+                else if(m_BenchmarkShape == 2)
+                    DviCore::BatchRenderer::RoundedRect(transform, color, 0.4f);
+                else
+                    DviCore::TextRenderer::Text("Dvi", glm::translate(glm::mat4(1.0f), glm::vec3{x + 0.1f, y + 0.3f, 0.0f}) * glm::scale(glm::mat4(1.0f), glm::vec3{0.5f, 0.5f, 1.0f}), color);
+            }
+            if(m_BenchmarkBounds)
+                DviCore::BatchRenderer::Rect(glm::translate(glm::mat4(1.0f), glm::vec3{x + 0.5f, y + 0.5f, 0.0f}), glm::vec4{1.0f}, DviCore::BatchLineMode::Overlay);
+        }
+        DviCore::BatchRenderer::End();
+
+        std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+        m_BenchmarkTime = elapsed.count();
+    }
+
     void EditorLayer::OnEvent(DviCore::Event & event)
     {
     }
@@ -92,6 +224,7 @@ namespace Dvimana
         ImGui::Begin("Performance");
         ImGui::Text("Frames Per Second    : %.1f fps", ImGui::GetIO().Framerate);
         ImGui::Text("Application Average  : %.3f ms", 1000.0f / ImGui::GetIO().Framerate);
+        ImGui::Text("Framebuffer Samples  : %d", m_Framebuffer->GetFrameSpecification().Samples);
         ImGui::Text("Viewport size        : %.1f, %.1f", m_ViewportSize.x, m_ViewportSize.y);
         ImGui::End();
 
@@ -102,6 +235,140 @@ namespace Dvimana
         ImGui::Text("GLSL Version         : %s", DviCore::OpenGLInfo::GetGLSLVersion().c_str());
         ImGui::Text("Number Of Quads      : %d", DviCore::BatchRenderer::Status().QuadCount);
         ImGui::Text("Number Of DrawCalls  : %d", DviCore::BatchRenderer::Status().DrawCount);
+        ImGui::Text("Fence Waits          : %d", DviCore::BatchRenderer::Status().FenceWaitCount);
+        ImGui::Text("Fence Wait Time      : %.3f ms", DviCore::BatchRenderer::Status().FenceWaitTime);
+        ImGui::Text("Uploaded Bytes       : %.1f KB", DviCore::BatchRenderer::Status().UploadBytes / 1024.0f);
+        ImGui::Text("Flushes Avoided      : %d", DviCore::BatchRenderer::Status().FlushesAvoided);
+        ImGui::Text("Opaque Quads         : %d", DviCore::BatchRenderer::Status().OpaqueCount);
+        ImGui::Text("Culled Quads         : %d", DviCore::BatchRenderer::Status().CulledCount);
+        ImGui::Text("Indirect Commands    : %d", DviCore::BatchRenderer::Status().IndirectCommandCount);
+        ImGui::Text("Point Sprites        : %d", DviCore::BatchRenderer::Status().PointCount);
+        ImGui::Text("Color-Only Draws     : %d", DviCore::BatchRenderer::Status().ColorOnlyDrawCount);
+        ImGui::Text("Single-Texture Draws : %d", DviCore::BatchRenderer::Status().SingleTextureDrawCount);
+        ImGui::Text("Debug Lines          : %d in %d draws", DviCore::BatchRenderer::Status().LineCount, DviCore::BatchRenderer::Status().LineDrawCount);
+        ImGui::Text("Text Glyphs          : %d, %d runs cached", DviCore::TextRenderer::Status().GlyphCount, DviCore::TextRenderer::Status().CachedRuns);
+        ImGui::Text("GL Calls Issued      : %d", DviCore::GLStateCache::Status().IssuedCalls);
+        ImGui::Text("GL Calls Elided      : %d", DviCore::GLStateCache::Status().ElidedCalls);
+        if(m_Scene->GetSpriteBuffer())
+        {
+            const auto& spriteStatus = m_Scene->GetSpriteBuffer()->Status();
+            ImGui::Text("Retained Sprites     : %d", m_Scene->GetSpriteBuffer()->SpriteCount());
+            ImGui::Text("Sprite Uploads       : %.1f KB in %d ranges", spriteStatus.UploadBytes / 1024.0f, spriteStatus.UploadRanges);
+            if(const DviCore::SpriteCuller* culler = m_Scene->GetSpriteBuffer()->Culler())
+                ImGui::Text("GPU Culling          : %d visible, %d culled", culler->Status().VisibleCount, culler->Status().CulledCount);
+        }
+        if(m_BenchmarkTilemap)
+        {
+            const auto& tilemap = *m_TilemapEntity.GetComponent<TilemapComponent>().Map;
+            ImGui::Text("Tilemap Chunks       : %d of %d visible, %d rebuilt", tilemap.Status().VisibleChunks, tilemap.ChunkCount(), tilemap.Status().ChunkRebuilds);
+            ImGui::Text("Tilemap Tiles        : %d", tilemap.Status().TileCount);
+        }
+        if(!m_LayerEntities.empty())
+        {
+            DviCore::CachedLayer::LayerStatus layerStatus = m_Scene->GetCachedLayerStatus();
+            ImGui::Text("Cached Layers        : %d captured, %d reused", layerStatus.Captures, layerStatus.Reuses);
+        }
+        if(m_BenchmarkParticles > 0)
+        {
+            const auto& particles = *m_ParticleEntity.GetComponent<ParticleSystemComponent>().System;
+            ImGui::Text("Live Particles       : %d", (uint32_t)particles.Count());
+            ImGui::Text("Particle Update/Draw : %.3f ms / %.3f ms", particles.Status().UpdateTime, particles.Status().DrawTime);
+        }
+        const char* textureBackends[] = { "Slots", "Arrays", "Bindless" };
+        ImGui::Text("Texture Backend      : %s", textureBackends[(int)DviCore::BatchRenderer::GetTextureBackend()]);
+        ImGui::End();
+
+        ImGui::Begin("Batch Benchmark");
+        const char* renderModes[] = { "Vertices", "Instanced" };
+        int renderMode = (int)DviCore::BatchRenderer::GetRenderMode();
+        if(ImGui::Combo("Render Mode", &renderMode, renderModes, 2))
+            DviCore::BatchRenderer::SetRenderMode((DviCore::BatchRenderMode)renderMode);
+
+        const char* vertexLayouts[] = { "Standard", "Compact" };
+        int vertexLayout = (int)DviCore::BatchRenderer::GetVertexLayout();
+        if(ImGui::Combo("Vertex Layout", &vertexLayout, vertexLayouts, 2))
+            DviCore::BatchRenderer::SetVertexLayout((DviCore::BatchVertexLayout)vertexLayout);
+
+        const char* submissions[] = { "Direct", "Indirect" };
+        int submission = (int)DviCore::BatchRenderer::GetSubmission();
+        if(ImGui::Combo("Submission", &submission, submissions, 2))
+            DviCore::BatchRenderer::SetSubmission((DviCore::BatchSubmission)submission);
+
+        const char* cornerKernels[] = { "Scalar", "SSE2", "AVX2", "Reference (glm)" };
+        int cornerKernel = (int)DviCore::QuadKernel::GetBackend();
+        if(ImGui::Combo("Corner Kernel", &cornerKernel, cornerKernels, 4))
+        {
+            if(!DviCore::QuadKernel::SetBackend((DviCore::QuadKernelBackend)cornerKernel))
+                DVI_WARN("Corner kernel {0} is not supported on this CPU!", cornerKernels[cornerKernel]);
+        }
+
+        bool retainedSprites = m_Scene->GetRetainedSprites();
+        if(ImGui::Checkbox("Retained Sprites", &retainedSprites))
+            m_Scene->SetRetainedSprites(retainedSprites);
+
+        bool gpuCulling = m_Scene->GetGPUSpriteCulling();
+        if(ImGui::Checkbox("GPU Sprite Culling", &gpuCulling))
+            m_Scene->SetGPUSpriteCulling(gpuCulling);
+
+        bool culling = DviCore::BatchRenderer::GetCulling();
+        if(ImGui::Checkbox("Frustum Culling", &culling))
+            DviCore::BatchRenderer::SetCulling(culling);
+
+        bool sortQueue = DviCore::BatchRenderer::GetQueueSorting();
+        if(ImGui::Checkbox("Sort Queue", &sortQueue))
+            DviCore::BatchRenderer::SetQueueSorting(sortQueue);
+
+        // Analytic edges against multisampling, both at the viewport's resolution so their frame times compare directly.
+        const char* antiAliasing[] = { "Off", "Analytic Edges", "MSAA 4x", "MSAA 8x" };
+        if(ImGui::Combo("Anti-Aliasing", &m_AntiAliasing, antiAliasing, 4))
+        {
+            const uint32_t samples[] = { 1, 1, 4, 8 };
+            DviCore::BatchRenderer::SetEdgeAntialiasing(m_AntiAliasing == 1);
+            m_Framebuffer->SetSamples(samples[m_AntiAliasing]);
+        }
+        if(m_AntiAliasing == 1 && DviCore::BatchRenderer::GetRenderMode() != DviCore::BatchRenderMode::Instanced)
+            ImGui::TextDisabled("Analytic edges only apply in instanced mode");
+
+        if(ImGui::Checkbox("Benchmark Tilemap", &m_BenchmarkTilemap))
+        {
+            if(m_BenchmarkTilemap)
+                CreateBenchmarkTilemap();
+            else
+                m_Scene->DestroyEntity(m_TilemapEntity);
+        }
+
+        bool benchmarkLayer = !m_LayerEntities.empty();
+        if(ImGui::Checkbox("Benchmark Cached Layer", &benchmarkLayer))
+            SetBenchmarkLayer(benchmarkLayer);
+
+        bool layerCaching = m_Scene->GetLayerCaching();
+        if(ImGui::Checkbox("Layer Caching", &layerCaching))
+            m_Scene->SetLayerCaching(layerCaching);
+
+        ImGui::Checkbox("Benchmark Bounds", &m_BenchmarkBounds);
+        const char* benchmarkShapes[] = { "Quads", "Circles", "Rounded Rects", "Text", "Points" };
+        ImGui::Combo("Benchmark Shape", &m_BenchmarkShape, benchmarkShapes, 5);
+
+        const uint32_t benchmarkCounts[] = { 0, 10000, 100000, 1000000 };
+        const char* benchmarkLabels[] = { "Off", "10k Quads", "100k Quads", "1M Quads" };
+        for(int i = 0; i < 4; i++)
+        {
+            if(ImGui::RadioButton(benchmarkLabels[i], m_BenchmarkQuads == benchmarkCounts[i]))
+                m_BenchmarkQuads = benchmarkCounts[i];
+            ImGui::SameLine();
+        }
+        ImGui::NewLine();
+
+        const uint32_t particleCounts[] = { 0, 10000, 100000, 1000000 };
+        const char* particleLabels[] = { "Off##Particles", "10k Particles", "100k Particles", "1M Particles" };
+        for(int i = 0; i < 4; i++)
+        {
+            if(ImGui::RadioButton(particleLabels[i], m_BenchmarkParticles == particleCounts[i]) && m_BenchmarkParticles != particleCounts[i])
+                SetBenchmarkParticles(particleCounts[i]);
+            ImGui::SameLine();
+        }
+        ImGui::NewLine();
+        ImGui::Text("Submit + Flush       : %.3f ms", m_BenchmarkTime);
         ImGui::End();
 
         ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
@@ -21,6 +21,12 @@ namespace Dvimana
             virtual void OnEvent(DviCore::Event& event) override;
             virtual void OnImGuiRender() override;
 
+        private:
+            void RenderBenchmark();
+            void CreateBenchmarkTilemap();
+            void SetBenchmarkParticles(uint32_t count);
+            void SetBenchmarkLayer(bool enabled);
+
         private:
             std::shared_ptr<DviCore::Window> m_Window{nullptr};
             std::shared_ptr<DviCore::ImGuiLayer> m_ImGuiLayer{nullptr};
@@ -37,5 +43,20 @@ namespace Dvimana
 
             std::shared_ptr<DviCore::Texture> m_Texture{nullptr};
             glm::vec4 m_Color{0.2f, 0.3f, 0.8f, 1.0f};
+
+            DviCore::Camera2D m_BenchmarkCamera;
+            uint32_t m_BenchmarkQuads{0};
+            bool m_BenchmarkBounds{false};
+            int m_BenchmarkShape{0};
+            float m_BenchmarkTime{0.0f};
+            int m_AntiAliasing{0};
+
+            Entity m_TilemapEntity;
+            bool m_BenchmarkTilemap{false};
+
+            Entity m_ParticleEntity;
+            uint32_t m_BenchmarkParticles{0};
+
+            std::vector<Entity> m_LayerEntities;
     };
 }
\ No newline at end of file
@@ -47,6 +47,66 @@ namespace Dvimana
         ~SpriteComponent() = default;
     };
 
+    // Added by the scene in retained sprite mode, holds the sprite's buffer slot and what was last written to it.
+    struct SpriteSlotComponent 
+    {
+        static const uint32_t INVALID_SLOT = UINT32_MAX;
+
+        uint32_t Slot{INVALID_SLOT};
+        TransformComponent Transform;
+        glm::vec4 Color{1.0f, 1.0f, 1.0f, 1.0f};
+
+        SpriteSlotComponent() = default;
+        ~SpriteSlotComponent() = default;
+
+        bool Changed(const TransformComponent& transform, const SpriteComponent& sprite) const 
+        {
+            return Transform.Translation != transform.Translation || Transform.Rotation != transform.Rotation ||
+                   Transform.Scale != transform.Scale || Color != sprite.Color;
+        }
+    };
+
+    // Puts the entity's sprite into a static render layer instead of the regular sprite pass, the layer is drawn into a cached
+    // frame. Transform, Color and CapturedLayer hold the member as it was at the layer's last capture, Changed() reports a
+    // difference so the scene invalidates the layer.
+    struct CachedLayerComponent 
+    {
+        uint32_t Layer{0};
+
+        uint32_t CapturedLayer{UINT32_MAX};
+        TransformComponent Transform;
+        glm::vec4 Color{1.0f, 1.0f, 1.0f, 1.0f};
+
+        CachedLayerComponent() = default;
+        CachedLayerComponent(uint32_t layer) : Layer(layer) {}
+        ~CachedLayerComponent() = default;
+
+        bool Changed(const TransformComponent& transform, const SpriteComponent& sprite) const 
+        {
+            return Layer != CapturedLayer || Transform.Translation != transform.Translation || Transform.Rotation != transform.Rotation ||
+                   Transform.Scale != transform.Scale || Color != sprite.Color;
+        }
+    };
+
+    // The map's chunks hold their own GPU buffers, copies of the component share one map.
+    struct TilemapComponent 
+    {
+        std::shared_ptr<DviCore::Tilemap> Map{nullptr};
+
+        TilemapComponent() = default;
+        TilemapComponent(const DviCore::TilemapSpecifications& specification) : Map(std::make_shared<DviCore::Tilemap>(specification)) {}
+        ~TilemapComponent() = default;
+    };
+
+    struct ParticleSystemComponent 
+    {
+        std::shared_ptr<DviCore::ParticleSystem> System{nullptr};
+
+        ParticleSystemComponent() = default;
+        ParticleSystemComponent(const DviCore::ParticleSystemSpecifications& specification) : System(std::make_shared<DviCore::ParticleSystem>(specification)) {}
+        ~ParticleSystemComponent() = default;
+    };
+
     struct CameraComponent 
     {
         SceneCamera Camera;
@@ -1,8 +1,22 @@
 #include "Scene.hpp"
 #include "Components.hpp"
 
+#include <future>
+#include <thread>
+
 namespace Dvimana 
 {
+    static const size_t SPRITES_PER_RECORDER = 16384;
+
+    Scene::Scene()
+    {
+        m_Registry.on_destroy<SpriteComponent>().connect<&Scene::OnSpriteReleased>(this);
+        m_Registry.on_destroy<SpriteSlotComponent>().connect<&Scene::OnSpriteReleased>(this);
+        m_Registry.on_construct<CachedLayerComponent>().connect<&Scene::OnLayerMemberAdded>(this);
+        m_Registry.on_destroy<CachedLayerComponent>().connect<&Scene::OnLayerMemberReleased>(this);
+        m_Registry.on_destroy<SpriteComponent>().connect<&Scene::OnLayerMemberReleased>(this);
+    }
+
     void Scene::OnUpdate(DviCore::TimeSteps deltaTime)
     {
         m_Registry.view<NativeScriptComponent>().each([=](auto entity, auto& nsc)
@@ -17,6 +31,8 @@ namespace Dvimana
             nsc.Instance->OnUpdate(deltaTime);
         });
 
+        UpdateParticles(deltaTime);
+
         DviCore::Camera* primaryCamera{nullptr};
         glm::mat4 cameraTransform{glm::mat4(1.0f)};
 
@@ -32,21 +48,333 @@ namespace Dvimana
             }
         }
 
+        // Tilemaps draw first, under the sprites, and before the batch binds its shader for the frame. Stale layers are
+        // captured before the frame's batch opens, they draw into their own frames.
         if(primaryCamera != nullptr)
+        {
+            DviCore::Renderer::UpdateFrameConstants(glm::inverse(cameraTransform), primaryCamera->GetProjectionMatirx());
+            DrawTilemaps();
+            UpdateCachedLayers(glm::inverse(cameraTransform), primaryCamera->GetProjectionMatirx());
+        }
+
+        if(primaryCamera != nullptr && m_RetainedSprites)
+        {
+            if(!m_CachedLayers.empty())
+            {
+                DviCore::BatchRenderer::Begin(*primaryCamera, cameraTransform);
+                DrawCachedLayers();
+                DviCore::BatchRenderer::End();
+            }
+
+            UpdateSpriteBuffer();
+            m_SpriteBuffer->Draw();
+
+            if(!m_SpriteTransforms.empty() || !m_Registry.view<ParticleSystemComponent>().empty())
+            {
+                DviCore::BatchRenderer::Begin(*primaryCamera, cameraTransform);
+                if(!m_SpriteTransforms.empty())
+                    DviCore::BatchRenderer::Quads(m_SpriteTransforms, m_SpriteColors);
+
+                DrawParticles();
+                DviCore::BatchRenderer::End();
+            }
+        }
+        else if(primaryCamera != nullptr)
         {
             DviCore::BatchRenderer::Begin(*primaryCamera, cameraTransform);
+            DrawCachedLayers();
 
-            auto group = m_Registry.group<TransformComponent>(entt::get<SpriteComponent>);
-            for(auto entity : group)
+            auto group = m_Registry.group<TransformComponent>(entt::get<SpriteComponent>, entt::exclude<CachedLayerComponent>);
+            size_t recorderCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), group.size() / SPRITES_PER_RECORDER);
+
+            // Recorded batches bypass the sort queue, so sorted frames keep the opaque/translucent passes on one thread.
+            if(recorderCount <= 1 || DviCore::BatchRenderer::GetQueueSorting())
             {
-                auto [transform, sprite] = group.get<TransformComponent, SpriteComponent>(entity);
-                DviCore::BatchRenderer::Quad(transform.GetTransform(), sprite.Color);
+                m_SpriteTransforms.clear();
+                m_SpriteColors.clear();
+                m_SpriteTransforms.reserve(group.size());
+                m_SpriteColors.reserve(group.size());
+
+                group.each([this](const auto& transform, const auto& sprite)
+                {
+                    m_SpriteTransforms.push_back(transform.GetTransform());
+                    m_SpriteColors.push_back(sprite.Color);
+                });
+
+                DviCore::BatchRenderer::Quads(m_SpriteTransforms, m_SpriteColors);
+            }
+            else
+            {
+                // Each worker records a contiguous slice of the group, merging in slice order keeps the draw order stable.
+                m_SpriteRecorders.resize(recorderCount);
+                std::vector<std::future<void>> jobs;
+                size_t slice = (group.size() + recorderCount - 1) / recorderCount;
+
+                for(size_t i = 0; i < recorderCount; i++)
+                {
+                    size_t first = i * slice;
+                    size_t last = std::min(first + slice, group.size());
+                    jobs.push_back(std::async(std::launch::async, [this, &group, i, first, last]()
+                    {
+                        DviCore::BatchRecorder& recorder = m_SpriteRecorders[i];
+                        recorder.Reset();
+
+                        for(auto it = group.begin() + first; it != group.begin() + last; ++it)
+                        {
+                            auto [transform, sprite] = group.get<TransformComponent, SpriteComponent>(*it);
+                            recorder.Quad(transform.GetTransform(), sprite.Color);
+                        }
+                    }));
+                }
+
+                for(size_t i = 0; i < recorderCount; i++)
+                {
+                    jobs[i].wait();
+                    DviCore::BatchRenderer::Merge(m_SpriteRecorders[i]);
+                }
             }
 
+            DrawParticles();
             DviCore::BatchRenderer::End();
         }
     }
 
+    void Scene::SetRetainedSprites(bool retained)
+    {
+        if(retained == m_RetainedSprites)
+            return;
+
+        m_RetainedSprites = retained;
+        if(!retained)
+        {
+            m_Registry.clear<SpriteSlotComponent>();
+            m_SpriteBuffer.reset();
+        }
+    }
+
+    void Scene::SetGPUSpriteCulling(bool enabled)
+    {
+        m_GPUSpriteCulling = enabled;
+        if(m_SpriteBuffer)
+            m_SpriteBuffer->SetGPUCulling(enabled);
+    }
+
+    // Only sprites whose transform or color changed since their last write are touched, the buffer sends just those
+    // slots on the next draw.
+    void Scene::UpdateSpriteBuffer()
+    {
+        if(!m_SpriteBuffer)
+        {
+            m_SpriteBuffer = std::make_unique<DviCore::SpriteBuffer>();
+            m_SpriteBuffer->SetGPUCulling(m_GPUSpriteCulling);
+        }
+
+        m_SpriteTransforms.clear();
+        m_SpriteColors.clear();
+        bool gpuCulling = m_SpriteBuffer->GetGPUCulling();
+
+        auto group = m_Registry.group<TransformComponent>(entt::get<SpriteComponent>, entt::exclude<CachedLayerComponent>);
+        for(auto entity : group)
+        {
+            auto [transform, sprite] = group.get<TransformComponent, SpriteComponent>(entity);
+
+            // The GPU culler doesn't keep the sprites' order, blended sprites would flicker where they overlap. They leave
+            // the buffer and are batched in registry order after it instead.
+            if(gpuCulling && sprite.Color.a < 1.0f)
+            {
+                if(m_Registry.any_of<SpriteSlotComponent>(entity))
+                    m_Registry.remove<SpriteSlotComponent>(entity);
+
+                m_SpriteTransforms.push_back(transform.GetTransform());
+                m_SpriteColors.push_back(sprite.Color);
+                continue;
+            }
+
+            SpriteSlotComponent* slot = m_Registry.try_get<SpriteSlotComponent>(entity);
+            if(slot == nullptr)
+                slot = &m_Registry.emplace<SpriteSlotComponent>(entity);
+
+            if(slot->Slot == SpriteSlotComponent::INVALID_SLOT)
+                slot->Slot = m_SpriteBuffer->Allocate();
+            else if(!slot->Changed(transform, sprite))
+                continue;
+
+            slot->Transform = transform;
+            slot->Color = sprite.Color;
+            m_SpriteBuffer->Set(slot->Slot, transform.GetTransform(), sprite.Color);
+        }
+    }
+
+    void Scene::SetLayerCaching(bool enabled)
+    {
+        m_LayerCaching = enabled;
+        if(!enabled)
+        {
+            for(auto& [id, cache] : m_CachedLayers)
+                cache.Layer.reset();
+        }
+    }
+
+    DviCore::CachedLayer::LayerStatus Scene::GetCachedLayerStatus() const
+    {
+        DviCore::CachedLayer::LayerStatus status;
+        for(const auto& [id, cache] : m_CachedLayers)
+        {
+            if(cache.Layer)
+            {
+                status.Captures += cache.Layer->Status().Captures;
+                status.Reuses += cache.Layer->Status().Reuses;
+            }
+        }
+
+        return status;
+    }
+
+    void Scene::CachedLayerStatusReset()
+    {
+        for(auto& [id, cache] : m_CachedLayers)
+        {
+            if(cache.Layer)
+                cache.Layer->StatusReset();
+        }
+    }
+
+    // Members are compared against what their layer last drew, layers are only captured again when a member changed or
+    // the camera left the cached frame. Perspective cameras and disabled caching draw the members every frame instead.
+    void Scene::UpdateCachedLayers(const glm::mat4& view, const glm::mat4& projection)
+    {
+        for(auto& [id, cache] : m_CachedLayers)
+            cache.Members = 0;
+
+        auto members = m_Registry.view<TransformComponent, SpriteComponent, CachedLayerComponent>();
+        for(auto entity : members)
+        {
+            auto [transform, sprite, member] = members.get<TransformComponent, SpriteComponent, CachedLayerComponent>(entity);
+            LayerCache& cache = m_CachedLayers[member.Layer];
+            if(member.Changed(transform, sprite))
+            {
+                InvalidateLayer(member.CapturedLayer);
+                InvalidateLayer(member.Layer);
+                member.CapturedLayer = member.Layer;
+                member.Transform = transform;
+                member.Color = sprite.Color;
+            }
+
+            cache.Depth = cache.Members == 0 ? transform.Translation.z : std::min(cache.Depth, transform.Translation.z);
+            cache.Members++;
+        }
+
+        std::erase_if(m_CachedLayers, [](const auto& entry) { return entry.second.Members == 0; });
+
+        bool cacheable = m_LayerCaching && DviCore::CachedLayer::Supports(projection);
+        for(auto& [id, cache] : m_CachedLayers)
+        {
+            cache.Cached = cacheable;
+            if(!cacheable)
+                continue;
+
+            if(!cache.Layer)
+                cache.Layer = std::make_unique<DviCore::CachedLayer>();
+
+            if(cache.Layer->NeedsCapture(view, projection))
+            {
+                cache.Layer->BeginCapture(view, projection);
+                DrawLayerMembers(id);
+                cache.Layer->EndCapture();
+            }
+        }
+    }
+
+    // Layers draw under the regular sprites in the order of their ids.
+    void Scene::DrawCachedLayers()
+    {
+        for(auto& [id, cache] : m_CachedLayers)
+        {
+            if(cache.Cached)
+                cache.Layer->Draw(cache.Depth);
+            else
+                DrawLayerMembers(id);
+        }
+    }
+
+    void Scene::DrawLayerMembers(uint32_t layer)
+    {
+        auto members = m_Registry.view<TransformComponent, SpriteComponent, CachedLayerComponent>();
+        for(auto entity : members)
+        {
+            auto [transform, sprite, member] = members.get<TransformComponent, SpriteComponent, CachedLayerComponent>(entity);
+            if(member.Layer == layer)
+                DviCore::BatchRenderer::Quad(transform.GetTransform(), sprite.Color);
+        }
+    }
+
+    void Scene::InvalidateLayer(uint32_t layer)
+    {
+        auto found = m_CachedLayers.find(layer);
+        if(found != m_CachedLayers.end() && found->second.Layer)
+            found->second.Layer->Invalidate();
+    }
+
+    // A new member leaves the regular sprite pass, in retained mode that frees its sprite buffer slot.
+    void Scene::OnLayerMemberAdded(entt::registry& registry, entt::entity entity)
+    {
+        if(registry.any_of<SpriteSlotComponent>(entity))
+            registry.remove<SpriteSlotComponent>(entity);
+    }
+
+    void Scene::OnLayerMemberReleased(entt::registry& registry, entt::entity entity)
+    {
+        CachedLayerComponent* member = registry.try_get<CachedLayerComponent>(entity);
+        if(member != nullptr)
+            InvalidateLayer(member->CapturedLayer);
+    }
+
+    void Scene::DrawTilemaps()
+    {
+        auto view = m_Registry.view<TransformComponent, TilemapComponent>();
+        for(auto entity : view)
+        {
+            auto [transform, tilemap] = view.get<TransformComponent, TilemapComponent>(entity);
+            if(tilemap.Map != nullptr)
+                tilemap.Map->Draw(transform.GetTransform());
+        }
+    }
+
+    // Emitters follow their entity, the particles themselves stay where they were emitted.
+    void Scene::UpdateParticles(DviCore::TimeSteps deltaTime)
+    {
+        auto view = m_Registry.view<TransformComponent, ParticleSystemComponent>();
+        for(auto entity : view)
+        {
+            auto [transform, particles] = view.get<TransformComponent, ParticleSystemComponent>(entity);
+            if(particles.System != nullptr)
+                particles.System->Update(deltaTime, glm::vec2(transform.Translation));
+        }
+    }
+
+    void Scene::DrawParticles()
+    {
+        auto view = m_Registry.view<TransformComponent, ParticleSystemComponent>();
+        for(auto entity : view)
+        {
+            auto [transform, particles] = view.get<TransformComponent, ParticleSystemComponent>(entity);
+            if(particles.System != nullptr)
+                particles.System->Draw(transform.Translation.z);
+        }
+    }
+
+    void Scene::OnSpriteReleased(entt::registry& registry, entt::entity entity)
+    {
+        SpriteSlotComponent* slot = registry.try_get<SpriteSlotComponent>(entity);
+        if(slot == nullptr || slot->Slot == SpriteSlotComponent::INVALID_SLOT)
+            return;
+
+        if(m_SpriteBuffer)
+            m_SpriteBuffer->Free(slot->Slot);
+
+        slot->Slot = SpriteSlotComponent::INVALID_SLOT;
+    }
+
     void Scene::OnWindowResize(uint32_t width, uint32_t height)
     {
         m_ViewportWidth = width;
@@ -301,6 +629,12 @@ namespace Dvimana
                 ImGui::CloseCurrentPopup();
             }
 
+            if(ImGui::MenuItem("Cached Layer") && !m_SelectedEntity.HasComponent<CachedLayerComponent>())
+            {
+                m_SelectedEntity.AddComponent<CachedLayerComponent>();
+                ImGui::CloseCurrentPopup();
+            }
+
             ImGui::EndPopup();
         }
 
@@ -394,5 +728,12 @@ namespace Dvimana
             ImGui::ColorEdit4("Color", glm::value_ptr(component.Color));
         });
 
+        DrawComponentControls<CachedLayerComponent>("Cached Layer", entity, [](auto& component)
+        {
+            int layer = (int)component.Layer;
+            if(ImGui::InputInt("Layer", &layer) && layer >= 0)
+                component.Layer = (uint32_t)layer;
+        });
+
     }
 }
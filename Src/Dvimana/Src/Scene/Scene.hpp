@@ -3,6 +3,8 @@
 #include <DviCore/DviCore.hpp>
 #include <entt/entt.hpp>
 
+#include <map>
+
 namespace Dvimana 
 {
     class Entity;
@@ -12,7 +14,7 @@ namespace Dvimana
     class Scene
     {
         public:
-            Scene() = default;
+            Scene();
             ~Scene() = default;
 
             void OnUpdate(DviCore::TimeSteps deltaTime);
@@ -21,10 +23,53 @@ namespace Dvimana
             Entity CreateEntity(const std::string& name);
             void DestroyEntity(Entity entity);
 
+            void SetRetainedSprites(bool retained);
+            bool GetRetainedSprites() const { return m_RetainedSprites; }
+            DviCore::SpriteBuffer* GetSpriteBuffer() const { return m_SpriteBuffer.get(); }
+            void SetGPUSpriteCulling(bool enabled);
+            bool GetGPUSpriteCulling() const { return m_GPUSpriteCulling; }
+            void SetLayerCaching(bool enabled);
+            bool GetLayerCaching() const { return m_LayerCaching; }
+            DviCore::CachedLayer::LayerStatus GetCachedLayerStatus() const;
+            void CachedLayerStatusReset();
+
         private:
+            void UpdateSpriteBuffer();
+            void DrawTilemaps();
+            void UpdateParticles(DviCore::TimeSteps deltaTime);
+            void DrawParticles();
+            void OnSpriteReleased(entt::registry& registry, entt::entity entity);
+            void UpdateCachedLayers(const glm::mat4& view, const glm::mat4& projection);
+            void DrawCachedLayers();
+            void DrawLayerMembers(uint32_t layer);
+            void InvalidateLayer(uint32_t layer);
+            void OnLayerMemberAdded(entt::registry& registry, entt::entity entity);
+            void OnLayerMemberReleased(entt::registry& registry, entt::entity entity);
+
+        private:
+            // Declared before the registry so the buffer outlives the components holding its slots.
+            std::unique_ptr<DviCore::SpriteBuffer> m_SpriteBuffer{nullptr};
+            bool m_RetainedSprites{false};
+            bool m_GPUSpriteCulling{false};
+
+            struct LayerCache 
+            {
+                std::unique_ptr<DviCore::CachedLayer> Layer;
+                float Depth{0.0f};
+                uint32_t Members{0};
+                bool Cached{false};
+            };
+
+            std::map<uint32_t, LayerCache> m_CachedLayers;
+            bool m_LayerCaching{true};
+
             entt::registry m_Registry;
             uint32_t m_ViewportWidth = 0, m_ViewportHeight = 0;
 
+            std::vector<glm::mat4> m_SpriteTransforms;
+            std::vector<glm::vec4> m_SpriteColors;
+            std::vector<DviCore::BatchRecorder> m_SpriteRecorders;
+
             friend class Entity; 
             friend class ScenePanels;
             friend class Serializer;
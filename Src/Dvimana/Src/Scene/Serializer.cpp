@@ -74,6 +74,14 @@ namespace Dvimana
             emitter << YAML::EndMap;
         }
 
+        if(entity.HasComponent<CachedLayerComponent>())
+        {
+            emitter << YAML::Key << "CachedLayerComponent" << YAML::Value;
+            emitter << YAML::BeginMap;
+            emitter << YAML::Key << "Layer" << YAML::Value << entity.GetComponent<CachedLayerComponent>().Layer;
+            emitter << YAML::EndMap;
+        }
+
         emitter << YAML::EndMap;
     }
 